@@ -2159,6 +2159,9 @@ static void ACS_setLineBlocking(const ACSThread *thread, int tag, int block)
             break;
         }
     }
+
+    // EX_ML_BLOCKALL stops sight
+    P_ClearSightCache();
 }
 
 static void ACS_setLineMonsterBlocking(line_t *defaultLine, int tag, bool block)
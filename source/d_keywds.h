@@ -37,6 +37,14 @@
 #define E_PRINTF(f, a) __attribute__((format(printf, f, a)))
 #endif
 
+// Hint that memory at p is about to be read. Never faults, even on a bad
+// address, and does nothing where the compiler has no way to express it.
+#ifdef __GNUC__
+#define E_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define E_PREFETCH(p)
+#endif
+
 #if _MSC_VER >= 1400 && defined(_DEBUG) && !defined(EE_NO_SAL)
 #include <sal.h>
 #if _MSC_VER > 1400
@@ -1918,6 +1918,10 @@ static void D_DoomInit()
         singledemo = true;
     }
 
+    // A demo streamed out with -viddump gets exactly one frame per tic
+    if(M_CheckParm("-viddump"))
+        singletics = true;
+
     startlevel =
         estrdup(d_startlevel.mapname ? d_startlevel.mapname : G_GetNameForMap(d_startlevel.episode, d_startlevel.map));
 
@@ -97,6 +97,14 @@ CONSOLE_COMMAND(z_dumpcore, cf_hidden)
     Z_DumpCore();
 }
 
+CONSOLE_COMMAND(z_slabstats, 0)
+{
+    if(Console.argc && !Console.argv[0]->strCaseCmp("reset"))
+        ZoneSlab::ResetStats();
+    else
+        ZoneSlab::PrintStats();
+}
+
 CONSOLE_COMMAND(starttitle, cf_notnet)
 {
     // haleyjd 04/18/03
@@ -151,6 +159,18 @@ CONSOLE_COMMAND(animshot, 0)
     C_InstaPopup(); // turn off console
 }
 
+CONSOLE_COMMAND(burstshot, 0)
+{
+    if(!Console.argc)
+    {
+        C_Printf("screenshot every tic.\n"
+                 "usage: burstshot <tics>\n");
+        return;
+    }
+    M_BurstScreenShot(Console.argv[0]->toInt());
+    C_InstaPopup(); // turn off console
+}
+
 CONSOLE_COMMAND(screenshot, 0)
 {
     if(Console.cmdtype != c_typed)
@@ -423,6 +443,9 @@ CONSOLE_VARIABLE(shot_type, screenshot_pcx, 0) {}
 VARIABLE_BOOLEAN(screenshot_gamma, nullptr, yesno);
 CONSOLE_VARIABLE(shot_gamma, screenshot_gamma, 0) {}
 
+VARIABLE_INT(screenshot_pnglevel, nullptr, 0, 9, nullptr);
+CONSOLE_VARIABLE(shot_pnglevel, screenshot_pnglevel, 0) {}
+
 // textmode startup
 
 extern int textmode_startup;            // d_main.c
@@ -2238,6 +2238,9 @@ void G_Ticker()
         }
     }
 
+    // take burst shots, and report on shots written in the background
+    M_ScreenShotTicker();
+
     // killough 10/6/98: allow games to be saved during demo
     // playback, by the playback user (not by demo itself)
 
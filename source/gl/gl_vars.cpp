@@ -37,6 +37,7 @@ int  cfg_gl_filter_type;     // texture filtering type
 int  cfg_gl_texture_format;  // texture internal format
 bool cfg_gl_use_extensions;  // must be true for extensions to be used
 bool cfg_gl_arb_pixelbuffer; // enable ARB PBO extension
+bool cfg_gl_present_thread;  // present frames from a separate thread
 
 VARIABLE_INT(cfg_gl_colordepth, nullptr, 16, 32, nullptr);
 CONSOLE_VARIABLE(gl_colordepth, cfg_gl_colordepth, 0) {}
@@ -52,5 +53,8 @@ CONSOLE_VARIABLE(gl_use_extensions, cfg_gl_use_extensions, 0) {}
 VARIABLE_TOGGLE(cfg_gl_arb_pixelbuffer, nullptr, yesno);
 CONSOLE_VARIABLE(gl_arb_pixelbuffer, cfg_gl_arb_pixelbuffer, 0) {}
 
+VARIABLE_TOGGLE(cfg_gl_present_thread, nullptr, yesno);
+CONSOLE_VARIABLE(gl_presentthread, cfg_gl_present_thread, 0) {}
+
 // EOF
 
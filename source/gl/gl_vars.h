@@ -39,6 +39,7 @@ extern int  cfg_gl_colordepth;
 extern int  cfg_gl_filter_type;
 extern bool cfg_gl_use_extensions;
 extern bool cfg_gl_arb_pixelbuffer;
+extern bool cfg_gl_present_thread;
 
 void GL_AddCommands();
 
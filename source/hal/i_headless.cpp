@@ -0,0 +1,253 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Video driver that draws into memory, with no window or display.
+//  Selected with -headless, for measuring the renderer on machines without
+//  a display server and comparing its output between builds.
+//
+//  -framecrc <file> writes a CRC-32 of every frame and its palette to file.
+//  -framedump <dir> writes every frame to dir as a PNG.
+//
+
+#include "../z_zone.h"
+
+#include "../d_main.h"
+#include "../doomstat.h"
+#include "../m_argv.h"
+#include "../m_hash.h"
+#include "../m_qstr.h"
+#include "../v_misc.h"
+#include "../v_png.h"
+#include "../v_video.h"
+#include "../w_wad.h"
+#include "i_directory.h"
+#include "i_headless.h"
+
+static byte *headlessbuffer;
+
+static byte basepal[768];
+static byte curpal[768]; // basepal with gamma applied
+
+static int   framecount;
+static FILE *crcfile;
+static char *dumpdir;
+
+static HashData allframes(HashData::CRC32);
+
+//
+// Checksums the current frame, which covers its palette too, and adds it to
+// the running checksum of the whole run.
+//
+static uint32_t I_headlessFrameCRC()
+{
+    HashData frame(HashData::CRC32);
+
+    frame.addData(headlessbuffer, uint32_t(video.pitch * video.width));
+    frame.addData(curpal, sizeof(curpal));
+    frame.wrapUp();
+
+    const uint32_t crc = frame.getDigestPart(0);
+    allframes.addData(reinterpret_cast<const uint8_t *>(&crc), sizeof(crc));
+
+    return crc;
+}
+
+//
+// Writes the current frame out as a PNG.
+//
+static void I_headlessDumpFrame()
+{
+    byte *linear = emalloc(byte *, video.width * video.height);
+
+    // the screen is stored by columns
+    for(int x = 0; x < video.width; x++)
+    {
+        const byte *src  = headlessbuffer + x * video.pitch;
+        byte       *dest = linear + x;
+
+        for(int y = 0; y < video.height; y++, dest += video.width)
+            *dest = src[y];
+    }
+
+    qstring filename(dumpdir);
+    qstring name;
+    name.Printf(32, "frame%06d.png", framecount);
+    filename.pathConcatenate(name);
+
+    V_WritePNG(linear, video.width, video.height, filename.constPtr(), curpal);
+
+    efree(linear);
+}
+
+//
+// HeadlessVideoDriver::FinishUpdate
+//
+void HeadlessVideoDriver::FinishUpdate()
+{
+    if(crcfile)
+        fprintf(crcfile, "%d %08x\n", framecount, I_headlessFrameCRC());
+    if(dumpdir)
+        I_headlessDumpFrame();
+
+    ++framecount;
+}
+
+//
+// HeadlessVideoDriver::ReadScreen
+//
+// Get the current screen contents.
+//
+void HeadlessVideoDriver::ReadScreen(byte *scr)
+{
+    VBuffer temp;
+
+    V_InitVBufferFrom(&temp, vbscreen.width, vbscreen.height, vbscreen.height, video.bitdepth, scr);
+    V_BlitVBuffer(&temp, 0, 0, &vbscreen, 0, 0, vbscreen.width, vbscreen.height);
+    V_FreeVBuffer(&temp);
+}
+
+//
+// HeadlessVideoDriver::SetPalette
+//
+// Set the palette, or, if palette is nullptr, update the current palette to use
+// the current gamma setting.
+//
+void HeadlessVideoDriver::SetPalette(byte *palette)
+{
+    if(palette)
+        memcpy(basepal, palette, sizeof(basepal));
+
+    for(int i = 0; i < 768; i++)
+        curpal[i] = gammatable[usegamma][basepal[i]];
+}
+
+//
+// HeadlessVideoDriver::UnsetPrimaryBuffer
+//
+void HeadlessVideoDriver::UnsetPrimaryBuffer()
+{
+    if(headlessbuffer)
+    {
+        efree(headlessbuffer);
+        headlessbuffer = nullptr;
+    }
+    video.screens[0] = nullptr;
+}
+
+//
+// HeadlessVideoDriver::SetPrimaryBuffer
+//
+// The frame is kept by columns, like the screen surfaces of the SDL drivers.
+//
+void HeadlessVideoDriver::SetPrimaryBuffer()
+{
+    video.pitch    = video.height;
+    headlessbuffer = ecalloc(byte *, video.pitch, video.width);
+
+    video.screens[0] = headlessbuffer;
+}
+
+//
+// HeadlessVideoDriver::ShutdownGraphicsPartway
+//
+void HeadlessVideoDriver::ShutdownGraphicsPartway()
+{
+    UnsetPrimaryBuffer();
+}
+
+//
+// HeadlessVideoDriver::ShutdownGraphics
+//
+// Reports the checksum of the whole run, so two builds can be compared at a
+// glance.
+//
+void HeadlessVideoDriver::ShutdownGraphics()
+{
+    ShutdownGraphicsPartway();
+
+    if(crcfile)
+    {
+        allframes.wrapUp();
+        printf("Headless: %d frames, checksum %08x\n", framecount, allframes.getDigestPart(0));
+
+        fclose(crcfile);
+        crcfile = nullptr;
+    }
+    else
+        printf("Headless: %d frames\n", framecount);
+}
+
+//
+// HeadlessVideoDriver::InitGraphicsMode
+//
+// Takes its size from the same settings and parameters as the SDL drivers.
+// Returns false, as there's nothing that can fail to open.
+//
+bool HeadlessVideoDriver::InitGraphicsMode()
+{
+    static bool firsttime = true;
+
+    int resolutionWidth  = 640;
+    int resolutionHeight = 480;
+
+    Geom geom;
+
+    geom.parse(i_videomode);
+    I_CheckVideoCmdsOnce(geom);
+    I_ParseResolution(i_resolution, resolutionWidth, resolutionHeight, geom.width, geom.height);
+
+    video.width     = resolutionWidth;
+    video.height    = resolutionHeight;
+    video.bitdepth  = 8;
+    video.pixelsize = 1;
+
+    UnsetPrimaryBuffer();
+    SetPrimaryBuffer();
+
+    SetPalette(static_cast<byte *>(wGlobalDir.cacheLumpName("PLAYPAL", PU_CACHE)));
+
+    if(firsttime)
+    {
+        int p;
+
+        firsttime = false;
+
+        if((p = M_CheckParm("-framecrc")) && p < myargc - 1)
+        {
+            if(!(crcfile = I_fopen(myargv[p + 1], "w")))
+                printf("Headless: couldn't open %s for writing\n", myargv[p + 1]);
+        }
+
+        if((p = M_CheckParm("-framedump")) && p < myargc - 1)
+        {
+            I_CreateDirectory(qstring(myargv[p + 1]));
+            dumpdir = estrdup(myargv[p + 1]);
+        }
+    }
+
+    return false;
+}
+
+// The one and only global instance of the headless video driver.
+HeadlessVideoDriver i_headlessvideodriver;
+
+// EOF
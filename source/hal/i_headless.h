@@ -0,0 +1,58 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Video driver that draws into memory, with no window or display.
+//
+
+#ifndef I_HEADLESS_H__
+#define I_HEADLESS_H__
+
+// Grab the HAL video definitions
+#include "../i_video.h"
+
+//
+// Headless Video Driver
+//
+// Runs the whole display path into a buffer in memory. Frames can be
+// checksummed or written out as PNGs instead of being shown.
+//
+class HeadlessVideoDriver : public HALVideoDriver
+{
+protected:
+    virtual void SetPrimaryBuffer();
+    virtual void UnsetPrimaryBuffer();
+
+public:
+    virtual void FinishUpdate();
+    virtual void ReadScreen(byte *scr);
+    virtual void SetPalette(byte *pal);
+    virtual void ShutdownGraphics();
+    virtual void ShutdownGraphicsPartway();
+    virtual bool InitGraphicsMode();
+};
+
+// Global singleton instance
+extern HeadlessVideoDriver i_headlessvideodriver;
+
+#endif
+
+// EOF
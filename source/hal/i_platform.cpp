@@ -21,6 +21,11 @@
 // Authors: James Haley
 //
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
 #include "i_platform.h"
 
 int ee_current_platform = EE_CURRENT_PLATFORM;
@@ -34,5 +39,33 @@ int ee_platform_flags[EE_PLATFORM_MAX] = {
     0              // Unknown
 };
 
+//
+// Checks that both the CPU and the OS support AVX2. Callers still need the
+// instructions compiled in, so this is only meaningful on x86 builds.
+//
+bool I_CPUHasAVX2()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+
+    __cpuid(info, 0);
+    if(info[0] < 7)
+        return false;
+
+    // The OS must save the YMM registers (OSXSAVE, AVX, then XCR0 bits 1 and 2)
+    __cpuid(info, 1);
+    if(!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
 // EOF
 
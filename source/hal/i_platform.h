@@ -95,6 +95,9 @@ inline bool EE_PLATFORM_TEST(int flags)
     return (ee_platform_flags[ee_current_platform] & flags) == flags;
 }
 
+// Checks that both the CPU and the OS support AVX2
+bool I_CPUHasAVX2();
+
 #endif
 
 // EOF
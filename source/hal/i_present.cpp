@@ -0,0 +1,191 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Conversion of the 8-bit frame into 32-bit pixels for presenting.
+//
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define I_PRESENT_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define I_PRESENT_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#include "i_platform.h"
+#include "i_present.h"
+
+// Edge of the square blocks the frame is transposed in. One block row of
+// output pixels is exactly one 64-byte cache line.
+static constexpr int PRESENTBLOCK = 16;
+
+using expandfunc_t = void (*)(const byte *, uint32_t *, int, const uint32_t *);
+
+//
+// Plain palette expansion, unrolled by eight
+//
+static void I_expandPixelsScalar(const byte *src, uint32_t *dest, int count, const uint32_t *palette)
+{
+    for(; count >= 8; count -= 8, src += 8, dest += 8)
+    {
+        dest[0] = palette[src[0]];
+        dest[1] = palette[src[1]];
+        dest[2] = palette[src[2]];
+        dest[3] = palette[src[3]];
+        dest[4] = palette[src[4]];
+        dest[5] = palette[src[5]];
+        dest[6] = palette[src[6]];
+        dest[7] = palette[src[7]];
+    }
+    while(count--)
+        *dest++ = palette[*src++];
+}
+
+#ifdef I_PRESENT_AVX2
+#ifdef __GNUC__
+#define I_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define I_AVX2_TARGET
+#endif
+
+//
+// Palette expansion looking up eight pixels per gather
+//
+I_AVX2_TARGET static void I_expandPixelsAVX2(const byte *src, uint32_t *dest, int count, const uint32_t *palette)
+{
+    const int *const table = reinterpret_cast<const int *>(palette);
+
+    for(; count >= 8; count -= 8, src += 8, dest += 8)
+    {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), _mm256_i32gather_epi32(table, indices, 4));
+    }
+    while(count--)
+        *dest++ = palette[*src++];
+}
+#endif
+
+//
+// Picks the fastest expansion routine the running CPU supports
+//
+static expandfunc_t I_getExpandFunc()
+{
+#ifdef I_PRESENT_AVX2
+    static const bool hasavx2 = I_CPUHasAVX2();
+    if(hasavx2)
+        return I_expandPixelsAVX2;
+#endif
+    return I_expandPixelsScalar;
+}
+
+//
+// Transposes one PRESENTBLOCK-square block of the column-major frame, so that
+// tile row y holds the pixels of screen row y.
+//
+static void I_transposeBlock(const byte *src, int srcpitch, byte (&tile)[PRESENTBLOCK][PRESENTBLOCK])
+{
+#ifdef I_PRESENT_SSE2
+    __m128i rows[PRESENTBLOCK];
+
+    for(int i = 0; i < PRESENTBLOCK; i++)
+        rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcpitch));
+
+    // Four rounds of interleaving row i with row i + 8 amount to a full 16x16 byte transpose
+    for(int round = 0; round < 4; round++)
+    {
+        __m128i next[PRESENTBLOCK];
+
+        for(int i = 0; i < PRESENTBLOCK / 2; i++)
+        {
+            next[i * 2]     = _mm_unpacklo_epi8(rows[i], rows[i + PRESENTBLOCK / 2]);
+            next[i * 2 + 1] = _mm_unpackhi_epi8(rows[i], rows[i + PRESENTBLOCK / 2]);
+        }
+        for(int i = 0; i < PRESENTBLOCK; i++)
+            rows[i] = next[i];
+    }
+
+    for(int i = 0; i < PRESENTBLOCK; i++)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(tile[i]), rows[i]);
+#else
+    for(int x = 0; x < PRESENTBLOCK; x++)
+    {
+        const byte *column = src + x * srcpitch;
+        for(int y = 0; y < PRESENTBLOCK; y++)
+            tile[y][x] = column[y];
+    }
+#endif
+}
+
+//
+// Expands count 8-bit pixels through a 32-bit palette.
+//
+void I_ExpandPixels(const byte *src, uint32_t *dest, int count, const uint32_t *palette)
+{
+    I_getExpandFunc()(src, dest, count, palette);
+}
+
+//
+// Expands the column-major 8-bit frame through a 32-bit palette and transposes
+// it into a row-major destination, such as a locked streaming texture, in one
+// pass. Screen column x starts at src + x * srcpitch and holds height pixels;
+// destpitch is in bytes. Works in cache-sized blocks so neither the source
+// columns nor the destination rows get evicted between uses.
+//
+void I_ExpandTransposed(const byte *src, int srcpitch, int width, int height, const uint32_t *palette, void *dest,
+                        int destpitch)
+{
+    const expandfunc_t expand      = I_getExpandFunc();
+    const int          blockwidth  = width & ~(PRESENTBLOCK - 1);
+    const int          blockheight = height & ~(PRESENTBLOCK - 1);
+    byte *const        out         = static_cast<byte *>(dest);
+
+    alignas(16) byte tile[PRESENTBLOCK][PRESENTBLOCK];
+
+    for(int y = 0; y < blockheight; y += PRESENTBLOCK)
+    {
+        for(int x = 0; x < blockwidth; x += PRESENTBLOCK)
+        {
+            I_transposeBlock(src + x * srcpitch + y, srcpitch, tile);
+            for(int i = 0; i < PRESENTBLOCK; i++)
+                expand(tile[i], reinterpret_cast<uint32_t *>(out + (y + i) * destpitch) + x, PRESENTBLOCK, palette);
+        }
+
+        // Columns left over on the right
+        for(int x = blockwidth; x < width; x++)
+        {
+            const byte *column = src + x * srcpitch + y;
+            for(int i = 0; i < PRESENTBLOCK; i++)
+                reinterpret_cast<uint32_t *>(out + (y + i) * destpitch)[x] = palette[column[i]];
+        }
+    }
+
+    // Rows left over at the bottom
+    for(int y = blockheight; y < height; y++)
+    {
+        uint32_t *row = reinterpret_cast<uint32_t *>(out + y * destpitch);
+        for(int x = 0; x < width; x++)
+            row[x] = palette[src[x * srcpitch + y]];
+    }
+}
+
+// EOF
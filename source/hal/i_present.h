@@ -0,0 +1,38 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Conversion of the 8-bit frame into 32-bit pixels for presenting.
+//
+
+#ifndef I_PRESENT_H__
+#define I_PRESENT_H__
+
+#include "../doomtype.h"
+
+void I_ExpandPixels(const byte *src, uint32_t *dest, int count, const uint32_t *palette);
+
+void I_ExpandTransposed(const byte *src, int srcpitch, int width, int height, const uint32_t *palette, void *dest,
+                        int destpitch);
+
+#endif
+
+// EOF
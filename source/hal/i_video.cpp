@@ -25,6 +25,7 @@
 #include "../z_zone.h" /* memory allocation wrappers -- killough */
 
 // Need platform defines
+#include "i_headless.h"
 #include "i_platform.h"
 
 #include "SDL.h"
@@ -44,6 +45,7 @@
 #include "../m_argv.h"
 #include "../m_misc.h"
 #include "../m_qstr.h"
+#include "../m_viddump.h"
 #include "../r_context.h"
 #include "../r_main.h"
 #include "../st_stuff.h"
@@ -65,6 +67,9 @@
 
 static HALVideoDriver *i_video_driver = nullptr;
 
+// True when drawing to memory for -headless, with no window to take input from
+static bool i_headless;
+
 //=============================================================================
 //
 // Video Driver Table
@@ -177,7 +182,7 @@ void I_InitMouse();
 
 void I_StartTic()
 {
-    if(!D_noWindow())
+    if(!D_noWindow() && !i_headless)
         I_StartTicInWindow(i_video_driver->window);
 }
 
@@ -205,7 +210,10 @@ bool i_letterbox;
 void I_FinishUpdate()
 {
     if(!noblit && in_graphics_mode)
+    {
+        M_VidDumpFrame(video.screens[0], video.width, video.height, video.pitch);
         i_video_driver->FinishUpdate();
+    }
 }
 
 //
@@ -221,6 +229,9 @@ void I_ReadScreen(byte *scr)
 //
 void I_SetPalette(byte *palette)
 {
+    if(palette)
+        M_VidDumpSetPalette(palette);
+
     if(in_graphics_mode) // killough 8/11/98
         i_video_driver->SetPalette(palette);
 }
@@ -517,7 +528,7 @@ static bool I_InitGraphicsMode()
 
 #ifdef _MSC_VER
         // Win32 specific hacks
-        if(!D_noWindow())
+        if(!D_noWindow() && !i_headless)
             I_DisableSysMenu(i_video_driver->window);
 #endif
 
@@ -580,9 +591,17 @@ void I_InitGraphics()
 
     firsttime = false;
 
+    // The headless driver is only ever asked for on the command line, and
+    // isn't saved as the configured driver
+    if(M_CheckParm("-headless"))
+    {
+        i_video_driver = &i_headlessvideodriver;
+        i_headless     = true;
+        usermsg(" (using headless video driver)");
+    }
     // Select video driver based on configuration (out of those available in
     // the current compile), or get the default driver if unspecified
-    if(!(driveritem = I_DefaultVideoDriver()))
+    else if(!(driveritem = I_DefaultVideoDriver()))
     {
         I_Error("I_InitGraphics: invalid video driver %d\n", i_videodriverid);
     }
@@ -608,6 +627,9 @@ void I_InitGraphics()
 
     I_SetMode();
 
+    // -viddump: start streaming frames, now the screen's size is known
+    M_VidDumpInit();
+
     Z_CheckHeap();
 }
 
@@ -670,6 +692,8 @@ bool I_IsViewOccluded()
 {
     if(!i_video_driver)
         return true;
+    if(i_headless)
+        return false;
 
 #if EE_CURRENT_PLATFORM == EE_PLATFORM_MACOSX
     return I_IsMacViewOccluded(i_video_driver->window);
@@ -974,7 +974,7 @@ void HUDCrossHairWidget::drawer()
     if(!crosshair_scale)
     {
         drawx  = (video.width + 1 - w) / 2;
-        drawy  = viewwindow.y + (viewwindow.height + 1 - h) / 2;
+        drawy  = fullviewwindow.y + (fullviewwindow.height + 1 - h) / 2;
         buffer = &vbscreenfullres;
     }
     else
@@ -1985,7 +1985,7 @@ static cell AMX_NATIVE_CALL sm_gethudmode(AMX *amx, cell *params)
 {
     if(hud_enabled && hud_overlaylayout > 0) // Boom HUD enabled, return style
         return (cell)hud_overlaylayout + 1;
-    else if(viewwindow.height == video.height) // Fullscreen (no HUD)
+    else if(fullviewwindow.height == video.height) // Fullscreen (no HUD)
         return 0;
     else // Vanilla style status bar
         return 1;
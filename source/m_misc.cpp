@@ -60,11 +60,14 @@
 #include "p_partcl.h"
 #include "p_user.h"
 #include "r_draw.h"
+#include "r_dynres.h"
 #include "r_main.h"
+#include "r_pvs.h"
 #include "r_sky.h"
 #include "r_things.h"
 #include "s_sound.h"
 #include "st_stuff.h"
+#include "v_palmatch.h"
 #include "v_video.h"
 
 #ifdef HAVE_ADLMIDILIB
@@ -181,6 +184,12 @@ default_t defaults[] = {
     DEFAULT_INT("tran_filter_pct", &tran_filter_pct, nullptr, 66, 0, 100, default_t::wad_game,
                 "set percentage of foreground/background translucency mix"),
 
+    DEFAULT_BOOL("v_tablecache", &v_tablecache, nullptr, true, default_t::wad_no,
+                 "1 to keep generated translucency tables on disk instead of rebuilding them"),
+
+    DEFAULT_BOOL("v_patchcache", &v_patchcache, nullptr, true, default_t::wad_no,
+                 "1 to keep graphics drawn at the same place every frame pre-scaled"),
+
     // killough 2/8/98
     DEFAULT_INT("max_player_corpse", &default_bodyquesize, nullptr, 32, UL, UL, default_t::wad_no,
                 "number of dead bodies in view supported (negative value = no limit)"),
@@ -761,6 +770,9 @@ default_t defaults[] = {
     DEFAULT_INT("st_fsalpha", &st_fsalpha, nullptr, 100, 0, 100, default_t::wad_game,
                 "fullscreen HUD translucency level"),
 
+    DEFAULT_BOOL("st_cachebar", &st_cachebar, nullptr, true, default_t::wad_no,
+                 "1 to reuse the last drawing of the status bar while nothing on it changes"),
+
     DEFAULT_INT("c_speed", &c_speed, nullptr, 10, 1, 200, default_t::wad_no, "console speed, pixels/tic"),
 
     DEFAULT_INT("c_height", &c_height, nullptr, 100, 0, 200, default_t::wad_no, "console height, pixels"),
@@ -829,7 +841,7 @@ default_t defaults[] = {
     DEFAULT_STR("wad_directory", &wad_directory, nullptr, ".", default_t::wad_no, "user's default wad directory"),
 
     DEFAULT_INT("r_columnengine", &r_column_engine_num, nullptr, 0, 0, NUMCOLUMNENGINES - 1, default_t::wad_no,
-                "0 = normal"),
+                "0 = normal, 1 = batched"),
 
     DEFAULT_INT("r_spanengine", &r_span_engine_num, nullptr, 0, 0, NUMSPANENGINES - 1, default_t::wad_no,
                 "0 = high precision"),
@@ -840,6 +852,30 @@ default_t defaults[] = {
     DEFAULT_INT("r_sprprojstyle", &r_sprprojstyle, nullptr, 0, 0, R_SPRPROJSTYLE_NUM - 1, default_t::wad_no,
                 "Sprite projection style (0 = default, 1 = fast, 2 = thorough)"),
 
+    DEFAULT_INT("r_slopesubdiv", &r_slopesubdiv, nullptr, R_SLOPESUBDIV_16, 0, R_SLOPESUBDIV_NUM - 1,
+                default_t::wad_no, "Pixels between exact divides on sloped planes (0 = 8, 1 = 16)"),
+
+    DEFAULT_BOOL("r_pvs", &r_pvs, nullptr, false, default_t::wad_no,
+                 "1 to skip parts of the level which can't be seen from the view's sector (once worked out)"),
+
+    DEFAULT_BOOL("p_soundcache", &p_soundcache, nullptr, true, default_t::wad_no,
+                 "1 to remember which lines sound can pass until the sectors beside them move"),
+
+    DEFAULT_BOOL("p_sightcache", &p_sightcache, nullptr, true, default_t::wad_no,
+                 "1 to reuse sight checks between the same positions within a tic"),
+
+    DEFAULT_BOOL("r_dynres", &r_dynres, nullptr, false, default_t::wad_no,
+                 "1 to lower the 3D view's resolution when it takes too long to render"),
+
+    DEFAULT_INT("r_dynresbudget", &r_dynresbudget, nullptr, 12, 1, 100, default_t::wad_no,
+                "Milliseconds the 3D view may take to render before dynamic resolution lowers it"),
+
+    DEFAULT_INT("r_dynresminscale", &r_dynresminscale, nullptr, 50, 25, 100, default_t::wad_no,
+                "Lowest scale dynamic resolution may use, in percent of the full view size"),
+
+    DEFAULT_BOOL("r_radixsort", &r_radixsort, nullptr, true, default_t::wad_no,
+                 "1 to sort large numbers of sprites with a radix sort instead of a merge sort"),
+
     DEFAULT_INT("spechits_emulation", &spechits_emulation, nullptr, 0, 0, 2, default_t::wad_no,
                 "0 = off, 1 = emulate like Chocolate Doom, 2 = emulate like PrBoom+"),
 
@@ -21,15 +21,23 @@
 // Authors: James Haley, Max Waine
 //
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "z_zone.h"
 
+#include "concurrentqueue/concurrentqueue.h"
+
 #include "autopalette.h"
 #include "c_io.h"
 #include "d_gi.h"
 #include "d_io.h"
 #include "doomstat.h"
 #include "hal/i_directory.h"
+#include "i_system.h"
 #include "m_buffer.h"
+#include "m_compare.h"
 #include "m_qstr.h"
 #include "m_utils.h"
 #include "p_skin.h"
@@ -48,6 +56,9 @@ int screenshot_pcx;
 // haleyjd 11/16/04: allow disabling gamma correction in screenshots
 int screenshot_gamma;
 
+// zlib compression level of PNG shots, 0 to 9
+int screenshot_pnglevel = 6;
+
 // jff 3/30/98 binary file write with error detection
 // killough 10/98: changed into macro to return failure instead of aborting
 // MaxW: This uses the do { foo } while(false) pattern now to prevent side-effects
@@ -64,6 +75,21 @@ int screenshot_gamma;
 #define SafeWrite8(ob, data) \
     do { if(!ob->writeUint8(data)) return false; } while(false)
 
+// A screenshot waiting to be written, or being written by a worker thread
+struct shotjob_t
+{
+    byte    *data;         // the screen, by columns
+    uint32_t width;
+    uint32_t height;
+    size_t   size;         // allocated size of data
+    byte     palette[768]; // gamma corrected already if wanted
+    int      format;
+    int      pnglevel;
+    char    *filename;
+    bool     quiet;        // no sound when written, for all but the end of a burst
+    char     message[128]; // libpng's complaint, if any
+};
+
 //=============================================================================
 //
 // PCX
@@ -93,11 +119,12 @@ struct pcx_t
 //
 // pcx_Writer
 //
-static bool pcx_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t height, byte *palette)
+static bool pcx_Writer(OutBuffer *ob, shotjob_t &shot)
 {
-    unsigned int i;
-    pcx_t        pcx;
-    byte         temppal[768], *palptr;
+    const byte    *data   = shot.data;
+    const uint32_t width  = shot.width;
+    const uint32_t height = shot.height;
+    pcx_t          pcx;
 
     // Setup PCX Header
     // haleyjd 09/27/07: Changed pcx.palette_type from 2 to 1.
@@ -141,7 +168,7 @@ static bool pcx_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
     // clang-format on
 
     // Pack the image
-    byte *row;
+    const byte *row;
     for(unsigned int y = 0; y < height; y++)
     {
         row = data + y;
@@ -160,22 +187,7 @@ static bool pcx_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
 
     // Write the palette
     SafeWrite8(ob, 0x0c); // palette ID byte
-
-    // haleyjd 11/16/04: make gamma correction optional
-    if(screenshot_gamma)
-    {
-        for(i = 0; i < 768; i += 3)
-        {
-            temppal[i + 0] = gammatable[usegamma][palette[i + 0]]; // killough
-            temppal[i + 1] = gammatable[usegamma][palette[i + 1]];
-            temppal[i + 2] = gammatable[usegamma][palette[i + 2]];
-        }
-        palptr = temppal;
-    }
-    else
-        palptr = palette;
-
-    SafeWrite(ob, palptr, 768);
+    SafeWrite(ob, shot.palette, 768);
 
     // Done!
     return true;
@@ -223,8 +235,12 @@ struct BITMAPINFOHEADER
 //
 // jff 3/30/98 Add capability to write a .BMP file (256 color uncompressed)
 //
-static bool bmp_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t height, byte *palette)
+static bool bmp_Writer(OutBuffer *ob, shotjob_t &shot)
 {
+    const byte      *data    = shot.data;
+    const byte      *palette = shot.palette;
+    const uint32_t   width   = shot.width;
+    const uint32_t   height  = shot.height;
     unsigned int     i, j, wid;
     BITMAPFILEHEADER bmfh;
     BITMAPINFOHEADER bmih;
@@ -275,27 +291,13 @@ static bool bmp_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
     SafeWrite32(ob, bmih.biClrUsed);
     SafeWrite32(ob, bmih.biClrImportant);
 
-    // haleyjd 11/16/04: make gamma correction optional
-    if(screenshot_gamma)
-    {
-        // write the palette, in blue-green-red order, gamma corrected
-        for(i = j = 0; i < 768; i += 3, j += 4)
-        {
-            temppal[j + 0] = gammatable[usegamma][palette[i + 2]];
-            temppal[j + 1] = gammatable[usegamma][palette[i + 1]];
-            temppal[j + 2] = gammatable[usegamma][palette[i + 0]];
-            temppal[j + 3] = 0;
-        }
-    }
-    else
+    // write the palette, in blue-green-red order
+    for(i = j = 0; i < 768; i += 3, j += 4)
     {
-        for(i = j = 0; i < 768; i += 3, j += 4)
-        {
-            temppal[j + 0] = palette[i + 2];
-            temppal[j + 1] = palette[i + 1];
-            temppal[j + 2] = palette[i + 0];
-            temppal[j + 3] = 0;
-        }
+        temppal[j + 0] = palette[i + 2];
+        temppal[j + 1] = palette[i + 1];
+        temppal[j + 2] = palette[i + 0];
+        temppal[j + 3] = 0;
     }
     SafeWrite(ob, temppal, 1024);
 
@@ -337,11 +339,14 @@ struct tgaheader_t
 //
 // haleyjd 12/28/09
 //
-static bool tga_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t height, byte *palette)
+static bool tga_Writer(OutBuffer *ob, shotjob_t &shot)
 {
-    tgaheader_t  tga;
-    unsigned int i;
-    byte         temppal[768];
+    const byte    *data    = shot.data;
+    const byte    *palette = shot.palette;
+    const uint32_t width   = shot.width;
+    const uint32_t height  = shot.height;
+    tgaheader_t    tga;
+    byte           temppal[768];
 
     tga.idlength        = 0;                // no image identification field
     tga.colormaptype    = 1;                // colormapped image, palette is present
@@ -375,23 +380,11 @@ static bool tga_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
     // clang-format on
 
     // Write colormap
-    if(screenshot_gamma)
-    {
-        for(i = 0; i < 768; i += 3)
-        {
-            temppal[i + 0] = gammatable[usegamma][palette[i + 2]];
-            temppal[i + 1] = gammatable[usegamma][palette[i + 1]];
-            temppal[i + 2] = gammatable[usegamma][palette[i + 0]];
-        }
-    }
-    else
+    for(unsigned int i = 0; i < 768; i += 3)
     {
-        for(i = 0; i < 768; i += 3)
-        {
-            temppal[i + 0] = palette[i + 2];
-            temppal[i + 1] = palette[i + 1];
-            temppal[i + 2] = palette[i + 0];
-        }
+        temppal[i + 0] = palette[i + 2];
+        temppal[i + 1] = palette[i + 1];
+        temppal[i + 2] = palette[i + 0];
     }
     SafeWrite(ob, temppal, 768);
 
@@ -416,6 +409,7 @@ struct pngiodata_t
 {
     OutBuffer *ob;      // OutBuffer to call Write on.
     bool       writeOK; // Tracks if a write error has occurred.
+    shotjob_t *shot;    // Takes libpng's messages back to the game thread.
 };
 
 //
@@ -447,7 +441,9 @@ static void PNG_dataFlush(png_structp png_ptr)
 //
 static void PNG_handleError(png_structp png_ptr, png_const_charp error_msg)
 {
-    C_Printf(FC_ERROR "libpng error: %s\a", error_msg);
+    pngiodata_t *pngIoData = static_cast<pngiodata_t *>(png_get_error_ptr(png_ptr));
+
+    psnprintf(pngIoData->shot->message, sizeof(pngIoData->shot->message), "libpng error: %s\a", error_msg);
 
     throw 0;
 }
@@ -459,7 +455,10 @@ static void PNG_handleError(png_structp png_ptr, png_const_charp error_msg)
 //
 static void PNG_handleWarning(png_structp png_ptr, png_const_charp error_msg)
 {
-    C_Printf(FC_ERROR "libpng warning: %s", error_msg);
+    pngiodata_t *pngIoData = static_cast<pngiodata_t *>(png_get_error_ptr(png_ptr));
+
+    if(!*pngIoData->shot->message)
+        psnprintf(pngIoData->shot->message, sizeof(pngIoData->shot->message), "libpng warning: %s", error_msg);
 }
 
 //
@@ -470,15 +469,20 @@ static void PNG_handleWarning(png_structp png_ptr, png_const_charp error_msg)
 // Some code derived from WadGen, copyright 2011 Samuel 'Kaiser' Villarreal
 // Used under GPLv2.0 or later.
 //
-static bool png_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t height, byte *palette)
+static bool png_Writer(OutBuffer *ob, shotjob_t &shot)
 {
-    png_structp pngStruct;
-    png_infop   pngInfo;
-    png_colorp  pngPalette;
-    pngiodata_t pngIoData;
+    const byte    *data    = shot.data;
+    const byte    *palette = shot.palette;
+    const uint32_t width   = shot.width;
+    const uint32_t height  = shot.height;
+    png_structp    pngStruct;
+    png_infop      pngInfo;
+    png_colorp     pngPalette;
+    pngiodata_t    pngIoData;
 
     pngIoData.ob      = ob;
     pngIoData.writeOK = true;
+    pngIoData.shot    = &shot;
 
     byte *row_pointer;
 
@@ -506,25 +510,14 @@ static bool png_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
         // setup image header
         png_set_IHDR(pngStruct, pngInfo, width, height, 8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE,
                      PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_set_compression_level(pngStruct, shot.pnglevel);
 
         // setup palette
-        if(screenshot_gamma)
+        for(int i = 0; i < 256; i++)
         {
-            for(int i = 0; i < 256; i++)
-            {
-                pngPalette[i].red   = gammatable[usegamma][palette[i * 3 + 0]];
-                pngPalette[i].green = gammatable[usegamma][palette[i * 3 + 1]];
-                pngPalette[i].blue  = gammatable[usegamma][palette[i * 3 + 2]];
-            }
-        }
-        else
-        {
-            for(int i = 0; i < 256; i++)
-            {
-                pngPalette[i].red   = palette[i * 3 + 0];
-                pngPalette[i].green = palette[i * 3 + 1];
-                pngPalette[i].blue  = palette[i * 3 + 2];
-            }
+            pngPalette[i].red   = palette[i * 3 + 0];
+            pngPalette[i].green = palette[i * 3 + 1];
+            pngPalette[i].blue  = palette[i * 3 + 2];
         }
         // add palette to png
         png_set_PLTE(pngStruct, pngInfo, pngPalette, 256);
@@ -567,7 +560,7 @@ static bool png_Writer(OutBuffer *ob, byte *data, uint32_t width, uint32_t heigh
 // Shared Code
 //
 
-using ShotWriter_t = bool (*)(OutBuffer *, byte *, uint32_t, uint32_t, byte *);
+using ShotWriter_t = bool (*)(OutBuffer *, shotjob_t &);
 
 struct shotformat_t
 {
@@ -592,20 +585,237 @@ static shotformat_t shotFormats[SHOT_NUMSHOTFORMATS] = {
     { "png", OutBuffer::NENDIAN, png_Writer }, // Portable Network Graphics
 };
 
+//=============================================================================
 //
-// M_ScreenShot
+// Background Writing
 //
-// Modified by Lee Killough so that any number of shots can be taken,
-// the code is faster, and no annoying "screenshot" message appears.
+// Shots are copied out of the screen on the game thread and handed to worker
+// threads to be encoded and written, so that compressing a large PNG doesn't
+// hold up the game. The game only waits when every slot is still taken,
+// which a burst can do on a slow disk; shots are never dropped.
 //
-// killough 10/98: improved error-handling
+
+// What the game thread is told once a shot has been written
+struct shotresult_t
+{
+    bool success;
+    bool quiet;
+    int  error; // errno
+    char message[128];
+};
+
+static constexpr int MAXPENDINGSHOTS = 12;
+static constexpr int MAXSHOTWORKERS  = 4;
+
+static shotjob_t   shotjobs[MAXPENDINGSHOTS];
+static bool        shotqueued[MAXPENDINGSHOTS]; // waiting for a worker
+static bool        shotinuse[MAXPENDINGSHOTS];  // queued or being written
+static std::thread shotworkers[MAXSHOTWORKERS];
+static int         numshotworkers;
+
+static std::mutex              shotmutex;
+static std::condition_variable shotready; // workers wait for a shot or for quitting
+static std::condition_variable shotfree;  // the game waits for a free slot
+static bool                    shotquit;
+
+static moodycamel::ConcurrentQueue<shotresult_t> shotresults;
+
+static int burstshots; // tics left in a burst
+
 //
-void M_ScreenShot()
+// Writes a shot out to its file. Runs on a worker thread.
+//
+static shotresult_t M_writeShot(shotjob_t &shot)
 {
-    bool          success = false;
-    qstring       path;
+    shotresult_t  result = {};
     OutBuffer     ob;
-    shotformat_t *format = &shotFormats[screenshot_pcx];
+    shotformat_t &format = shotFormats[shot.format];
+
+    errno = 0;
+
+    if(ob.createFile(shot.filename, 512 * 1024, format.endian))
+    {
+        // killough 10/98: detect failure and remove file if error
+        result.success = format.writer(&ob, shot);
+
+        // haleyjd: close the buffer
+        ob.close();
+
+        // if not successful, remove the file now
+        if(!result.success)
+        {
+            int t = errno;
+            remove(shot.filename);
+            errno = t;
+        }
+    }
+
+    result.error = errno;
+    result.quiet = shot.quiet;
+    memcpy(result.message, shot.message, sizeof(result.message));
+
+    return result;
+}
+
+//
+// Worker thread
+//
+static void M_shotWorker()
+{
+    while(true)
+    {
+        int slot = -1;
+
+        {
+            std::unique_lock lock(shotmutex);
+            shotready.wait(lock, [&slot] {
+                for(int i = 0; i < MAXPENDINGSHOTS && slot < 0; i++)
+                {
+                    if(shotqueued[i])
+                        slot = i;
+                }
+                return shotquit || slot >= 0;
+            });
+
+            // only quit once everything queued has been written
+            if(slot < 0)
+                return;
+
+            shotqueued[slot] = false;
+        }
+
+        shotresults.enqueue(M_writeShot(shotjobs[slot]));
+
+        {
+            std::lock_guard lock(shotmutex);
+            efree(shotjobs[slot].filename);
+            shotjobs[slot].filename = nullptr;
+            shotinuse[slot]         = false;
+        }
+        shotfree.notify_one();
+    }
+}
+
+//
+// Writes out whatever is still queued at exit.
+//
+static void M_finishShots()
+{
+    {
+        std::lock_guard lock(shotmutex);
+        shotquit = true;
+    }
+    shotready.notify_all();
+
+    for(int i = 0; i < numshotworkers; i++)
+        shotworkers[i].join();
+    numshotworkers = 0;
+}
+
+//
+// Starts the workers with the first shot.
+//
+static void M_startShotWorkers()
+{
+    numshotworkers = emin(emax(int(std::thread::hardware_concurrency()) - 1, 1), MAXSHOTWORKERS);
+
+    for(int i = 0; i < numshotworkers; i++)
+        shotworkers[i] = std::thread(M_shotWorker);
+
+    I_AtExit(M_finishShots);
+}
+
+//
+// Reports on a written shot.
+//
+static void M_reportShot(const shotresult_t &result)
+{
+    if(*result.message)
+        C_Printf(FC_ERROR "%s", result.message);
+
+    // 1/18/98 killough: replace "SCREEN SHOT" acknowledgement with sfx
+    // players[consoleplayer].message = "screen shot"
+
+    // killough 10/98: print error message and change sound effect if error
+    if(!result.success)
+    {
+        doom_printf("%s", result.error ? strerror(result.error) : FC_ERROR "Could not take screenshot");
+        S_StartInterfaceSound(GameModeInfo->playerSounds[sk_oof]);
+    }
+    else if(!result.quiet)
+        S_StartInterfaceSound(GameModeInfo->c_BellSound);
+}
+
+//
+// Copies the screen into a free slot and queues it to be written.
+//
+static void M_queueShot(const char *filename, bool quiet)
+{
+    int slot = -1;
+
+    if(!numshotworkers)
+        M_startShotWorkers();
+
+    {
+        std::unique_lock lock(shotmutex);
+        shotfree.wait(lock, [&slot] {
+            for(int i = 0; i < MAXPENDINGSHOTS && slot < 0; i++)
+            {
+                if(!shotinuse[i])
+                    slot = i;
+            }
+            return slot >= 0;
+        });
+        shotinuse[slot] = true;
+    }
+
+    // A slot in use isn't touched by the workers until it's queued, so it's
+    // filled unlocked
+    shotjob_t &shot = shotjobs[slot];
+
+    // BMP rows are padded out to four pixels, and are read from the buffer
+    const size_t size = size_t((vbscreen.width + 3) & ~3) * vbscreen.height;
+    if(shot.size < size)
+    {
+        shot.data = erealloc(byte *, shot.data, size);
+        shot.size = size;
+    }
+    memset(shot.data, 0, size);
+
+    shot.width  = uint32_t(vbscreen.width);
+    shot.height = uint32_t(vbscreen.height);
+
+    // get screen graphics
+    VBuffer temp;
+    V_InitVBufferFrom(&temp, vbscreen.width, vbscreen.height, vbscreen.height, video.bitdepth, shot.data);
+    V_BlitVBuffer(&temp, 0, 0, &vbscreen, 0, 0, vbscreen.width, vbscreen.height);
+    V_FreeVBuffer(&temp);
+
+    // haleyjd 11/16/04: make gamma correction optional
+    AutoPalette pal(wGlobalDir);
+    for(int i = 0; i < 768; i++)
+        shot.palette[i] = screenshot_gamma ? gammatable[usegamma][pal[i]] : pal[i]; // killough
+
+    shot.format     = screenshot_pcx;
+    shot.pnglevel   = screenshot_pnglevel;
+    shot.filename   = estrdup(filename);
+    shot.quiet      = quiet;
+    shot.message[0] = '\0';
+
+    {
+        std::lock_guard lock(shotmutex);
+        shotqueued[slot] = true;
+    }
+    shotready.notify_one();
+}
+
+//
+// Picks the file name for a shot and queues it. Failures to find a name are
+// reported right away.
+//
+static void M_takeShot(bool quiet)
+{
+    qstring path;
 
     errno = 0;
 
@@ -619,9 +829,10 @@ void M_ScreenShot()
 
     if(!I_access(path.constPtr(), W_OK))
     {
-        static int shot;
-        char      *lbmname = nullptr;
-        int        tries   = 10000;
+        static int    shot;
+        char         *lbmname = nullptr;
+        int           tries   = 10000;
+        shotformat_t *format  = &shotFormats[screenshot_pcx];
 
         size_t len = M_StringAlloca(&lbmname, 2, 16, path.constPtr(), format->extension);
 
@@ -633,48 +844,62 @@ void M_ScreenShot()
         }
         while(!I_access(lbmname, F_OK) && --tries);
 
-        if(tries && ob.createFile(lbmname, 512 * 1024, format->endian))
+        if(tries)
         {
-            // killough 4/18/98: make palette stay around
-            // (PU_CACHE could cause crash)
-            // byte *pal = (byte *)wGlobalDir.cacheLumpName("PLAYPAL", PU_STATIC);
-            AutoPalette pal(wGlobalDir);
-
-            // get screen graphics
-            V_BlitVBuffer(&backscreen2, 0, 0, &vbscreen, 0, 0, vbscreen.width, vbscreen.height);
+            M_queueShot(lbmname, quiet);
+            return;
+        }
+    }
 
-            // killough 10/98: detect failure and remove file if error
-            success = format->writer(&ob, backscreen2.data, (uint32_t)(backscreen2.width),
-                                     (uint32_t)(backscreen2.height), pal.get());
+    shotresult_t result = {};
 
-            // haleyjd: close the buffer
-            ob.close();
+    result.error = errno;
+    M_reportShot(result);
+}
 
-            // if not successful, remove the file now
-            if(!success)
-            {
-                int t = errno;
-                remove(lbmname);
-                errno = t;
-            }
+//
+// M_ScreenShot
+//
+// Modified by Lee Killough so that any number of shots can be taken,
+// the code is faster, and no annoying "screenshot" message appears.
+//
+// killough 10/98: improved error-handling
+// The shot is written in the background; M_ScreenShotTicker reports on it.
+//
+void M_ScreenShot()
+{
+    M_takeShot(false);
+}
 
-            // killough 4/18/98: now you can mark it PU_CACHE
-            // Z_ChangeTag(pal, PU_CACHE); - haleyjd 9/30/12: not needed now.
-        }
-    }
+//
+// M_BurstScreenShot
+//
+// Takes a shot every tic for the given number of tics. Only the last one
+// rings the bell.
+//
+void M_BurstScreenShot(int tics)
+{
+    burstshots = emax(tics, 0);
+}
 
-    // 1/18/98 killough: replace "SCREEN SHOT" acknowledgement with sfx
-    // players[consoleplayer].message = "screen shot"
+//
+// M_ScreenShotTicker
+//
+// Called every tic: takes the next shot of a burst, and reports on the shots
+// the workers have finished.
+//
+void M_ScreenShotTicker()
+{
+    shotresult_t result;
 
-    // killough 10/98: print error message and change sound effect if error
-    if(!success)
+    if(burstshots)
     {
-        doom_printf("%s", errno ? strerror(errno) : FC_ERROR "Could not take screenshot");
-        S_StartInterfaceSound(GameModeInfo->playerSounds[sk_oof]);
+        --burstshots;
+        M_takeShot(burstshots != 0);
     }
-    else
-        S_StartInterfaceSound(GameModeInfo->c_BellSound);
+
+    while(shotresults.try_dequeue(result))
+        M_reportShot(result);
 }
 
 // EOF
-
@@ -24,10 +24,13 @@
 #ifndef M_SHOTS_H__
 #define M_SHOTS_H__
 
-extern int screenshot_pcx;   // killough 10/98
-extern int screenshot_gamma; // haleyjd  03/06
+extern int screenshot_pcx;      // killough 10/98
+extern int screenshot_gamma;    // haleyjd  03/06
+extern int screenshot_pnglevel;
 
 void M_ScreenShot(void);
+void M_BurstScreenShot(int tics);
+void M_ScreenShotTicker();
 
 #endif
 
@@ -194,6 +194,9 @@ static default_t sysdefaults[] = {
     DEFAULT_INT("screenshot_gamma", &screenshot_gamma, nullptr, 1, 0, 1, default_t::wad_no,
                 "1 to use gamma correction in screenshots"),
 
+    DEFAULT_INT("screenshot_pnglevel", &screenshot_pnglevel, nullptr, 6, 0, 9, default_t::wad_no,
+                "zlib compression level of PNG screenshots (0=none, 9=smallest)"),
+
     DEFAULT_INT("i_videodriverid", &i_videodriverid, nullptr, -1, -1, VDR_MAXDRIVERS - 1, default_t::wad_no,
                 i_videohelpstr),
 
@@ -221,6 +224,9 @@ static default_t sysdefaults[] = {
     DEFAULT_BOOL("gl_arb_pixelbuffer", &cfg_gl_arb_pixelbuffer, nullptr, false, default_t::wad_no,
                  "1 to enable use of GL ARB pixelbuffer object extension"),
 
+    DEFAULT_BOOL("gl_presentthread", &cfg_gl_present_thread, nullptr, false, default_t::wad_no,
+                 "1 to upload and present GL2D frames from a separate thread"),
+
     DEFAULT_INT("gl_colordepth", &cfg_gl_colordepth, nullptr, 32, 16, 32, default_t::wad_no,
                 "GL backend screen bitdepth (16, 24, or 32)"),
 
@@ -239,6 +245,12 @@ static default_t sysdefaults[] = {
     DEFAULT_INT("r_numcontexts", &r_numcontexts, nullptr, 1, 1, UL, default_t::wad_no,
                 "Amount of renderer threads to run"),
 
+    DEFAULT_BOOL("r_balancecontexts", &r_balancecontexts, nullptr, true, default_t::wad_no,
+                 "1 to resize renderer threads' view strips to balance their workload"),
+
+    DEFAULT_BOOL("r_parallelportals", &r_parallelportals, nullptr, false, default_t::wad_no,
+                 "1 to render portal windows that don't share columns on separate threads"),
+
 #ifdef _SDL_VER
     DEFAULT_INT("displaynum", &displaynum, nullptr, 0, 0, UL, default_t::wad_no,
                 "Display number that the window appears on"),
@@ -0,0 +1,413 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Streaming a demo out as video with -viddump
+//
+//  Every displayed frame is copied with its palette into a small pool of
+//  slots, and worker threads expand and write them out, so the game loop
+//  never waits on the disk. It only waits when every slot is still being
+//  encoded, which keeps a slow disk from eating all of memory.
+//
+//  The file name decides what gets written:
+//   .y4m - a YUV4MPEG2 stream (4:4:4), which ffmpeg and most encoders read.
+//   .png - a sequence of PNGs, name000000.png, name000001.png, ...
+//   else - raw RGB24 frames one after the other, with no header.
+//
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "z_zone.h"
+
+#include "d_main.h"
+#include "doomdef.h"
+#include "doomtype.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_compare.h"
+#include "m_viddump.h"
+#include "v_misc.h"
+#include "v_png.h"
+#include "v_video.h"
+#include "w_wad.h"
+#include "hal/i_directory.h"
+
+enum viddumpsink_e
+{
+    VIDDUMP_RAW,
+    VIDDUMP_Y4M,
+    VIDDUMP_PNG,
+};
+
+struct viddumpframe_t
+{
+    byte *pixels;       // copy of the screen, by columns
+    byte  palette[768]; // with gamma applied
+    int   number;
+    bool  inuse;        // queued or being encoded
+};
+
+struct viddumpworker_t
+{
+    std::thread thread;
+    byte       *out = nullptr; // the encoded frame
+};
+
+// Encoding threads are capped, as past a handful the disk is the limit
+static constexpr int MAXVIDDUMPWORKERS = 8;
+
+static viddumpsink_e    dumpsink;
+static FILE            *dumpfile;
+static char            *dumpbase; // PNG sequence name, without the extension
+static int              dumpwidth;
+static int              dumpheight;
+static viddumpframe_t  *dumpframes;
+static int              numdumpframes;
+static viddumpworker_t *dumpworkers;
+static int              numdumpworkers;
+
+static byte basepal[768];
+
+static std::mutex              dumpmutex;
+static std::condition_variable jobready;  // workers wait for a frame or for quitting
+static std::condition_variable slotfree;  // the game waits for a free slot
+static std::condition_variable writeturn; // workers wait for their turn to write
+
+// All protected by dumpmutex
+static int  framessubmitted; // frames handed to the workers
+static int  nextjob;         // next frame a worker picks up
+static int  nextwrite;       // next frame to go to the stream
+static bool shouldquit;
+static bool writeerror;
+
+static int skippedframes; // frames not the size the dump started at
+
+//
+// Expands a frame to RGB24 by rows.
+//
+static size_t M_vidDumpEncodeRaw(const viddumpframe_t &frame, byte *out)
+{
+    for(int x = 0; x < dumpwidth; x++)
+    {
+        const byte *src  = frame.pixels + x * dumpheight;
+        byte       *dest = out + x * 3;
+
+        for(int y = 0; y < dumpheight; y++, dest += dumpwidth * 3)
+        {
+            const byte *rgb = frame.palette + src[y] * 3;
+
+            dest[0] = rgb[0];
+            dest[1] = rgb[1];
+            dest[2] = rgb[2];
+        }
+    }
+
+    return size_t(dumpwidth) * dumpheight * 3;
+}
+
+//
+// Converts a frame to a Y4M frame with full Y, Cb and Cr planes. The palette
+// is converted once (BT.601, studio range), and each pixel is looked up.
+//
+static size_t M_vidDumpEncodeY4M(const viddumpframe_t &frame, byte *out)
+{
+    static constexpr char header[] = "FRAME\n";
+
+    byte ylut[256], ulut[256], vlut[256];
+
+    for(int i = 0; i < 256; i++)
+    {
+        const int r = frame.palette[i * 3 + 0];
+        const int g = frame.palette[i * 3 + 1];
+        const int b = frame.palette[i * 3 + 2];
+
+        ylut[i] = byte(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        ulut[i] = byte(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        vlut[i] = byte(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    const size_t planesize = size_t(dumpwidth) * dumpheight;
+
+    memcpy(out, header, sizeof(header) - 1);
+
+    byte *yplane = out + sizeof(header) - 1;
+    byte *uplane = yplane + planesize;
+    byte *vplane = uplane + planesize;
+
+    for(int x = 0; x < dumpwidth; x++)
+    {
+        const byte *src = frame.pixels + x * dumpheight;
+
+        for(int y = 0, ofs = x; y < dumpheight; y++, ofs += dumpwidth)
+        {
+            yplane[ofs] = ylut[src[y]];
+            uplane[ofs] = ulut[src[y]];
+            vplane[ofs] = vlut[src[y]];
+        }
+    }
+
+    return sizeof(header) - 1 + planesize * 3;
+}
+
+//
+// Writes a frame straight out as the next PNG of the sequence.
+//
+static void M_vidDumpWritePNG(const viddumpframe_t &frame, byte *out)
+{
+    for(int x = 0; x < dumpwidth; x++)
+    {
+        const byte *src  = frame.pixels + x * dumpheight;
+        byte       *dest = out + x;
+
+        for(int y = 0; y < dumpheight; y++, dest += dumpwidth)
+            *dest = src[y];
+    }
+
+    char filename[PATH_MAX + 1];
+    psnprintf(filename, sizeof(filename), "%s%06d.png", dumpbase, frame.number);
+
+    if(!V_WritePNG(out, dumpwidth, dumpheight, filename, frame.palette))
+    {
+        std::lock_guard lock(dumpmutex);
+        writeerror = true;
+    }
+}
+
+//
+// Worker thread. Frames are encoded in whatever order the workers get to
+// them, but go to the stream in the order they were shown.
+//
+static void M_vidDumpWorker(viddumpworker_t *worker)
+{
+    while(true)
+    {
+        viddumpframe_t *frame;
+
+        {
+            std::unique_lock lock(dumpmutex);
+            jobready.wait(lock, [] { return shouldquit || nextjob < framessubmitted; });
+
+            // only quit once everything queued has been written
+            if(nextjob == framessubmitted)
+                return;
+
+            frame = &dumpframes[nextjob++ % numdumpframes];
+        }
+
+        if(dumpsink == VIDDUMP_PNG)
+            M_vidDumpWritePNG(*frame, worker->out);
+        else
+        {
+            const size_t size = dumpsink == VIDDUMP_Y4M ? M_vidDumpEncodeY4M(*frame, worker->out) :
+                                                          M_vidDumpEncodeRaw(*frame, worker->out);
+
+            std::unique_lock lock(dumpmutex);
+            writeturn.wait(lock, [frame] { return nextwrite == frame->number; });
+
+            // Only the worker whose turn it is gets here, so the stream
+            // doesn't need the lock while it's written
+            const bool skip = writeerror;
+            lock.unlock();
+            const bool failed = !skip && fwrite(worker->out, 1, size, dumpfile) != size;
+            lock.lock();
+
+            writeerror = writeerror || failed;
+            ++nextwrite;
+        }
+
+        {
+            std::lock_guard lock(dumpmutex);
+            frame->inuse = false;
+        }
+        writeturn.notify_all();
+        slotfree.notify_one();
+    }
+}
+
+//
+// Waits for everything queued to be written, and closes the dump. Called at
+// exit.
+//
+static void M_vidDumpFinish()
+{
+    if(!dumpframes)
+        return;
+
+    {
+        std::lock_guard lock(dumpmutex);
+        shouldquit = true;
+    }
+    jobready.notify_all();
+
+    for(int i = 0; i < numdumpworkers; i++)
+    {
+        dumpworkers[i].thread.join();
+        efree(dumpworkers[i].out);
+    }
+
+    if(dumpfile)
+    {
+        writeerror = fclose(dumpfile) != 0 || writeerror;
+        dumpfile   = nullptr;
+    }
+
+    printf("VidDump: wrote %d frames", framessubmitted);
+    if(skippedframes)
+        printf(", skipped %d after a change of resolution", skippedframes);
+    printf(writeerror ? ", with write errors\n" : "\n");
+
+    for(int i = 0; i < numdumpframes; i++)
+        efree(dumpframes[i].pixels);
+    efree(dumpframes);
+    delete[] dumpworkers;
+    dumpworkers = nullptr;
+    if(dumpbase)
+        efree(dumpbase);
+
+    dumpframes = nullptr;
+}
+
+//
+// M_VidDumpInit
+//
+// Opens the dump given with -viddump and starts the encoding threads. Frames
+// are all the size of the screen at this point.
+//
+void M_VidDumpInit()
+{
+    int p;
+
+    if(dumpframes || !(p = M_CheckParm("-viddump")) || p >= myargc - 1)
+        return;
+
+    const char  *filename = myargv[p + 1];
+    const size_t len      = strlen(filename);
+
+    dumpwidth  = video.width;
+    dumpheight = video.height;
+
+    const size_t planesize = size_t(dumpwidth) * dumpheight;
+    size_t       outsize;
+
+    if(len > 4 && !strcasecmp(filename + len - 4, ".y4m"))
+    {
+        if(!(dumpfile = I_fopen(filename, "wb")))
+        {
+            usermsg("VidDump: couldn't open %s for writing", filename);
+            return;
+        }
+        fprintf(dumpfile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", dumpwidth, dumpheight, TICRATE);
+
+        dumpsink = VIDDUMP_Y4M;
+        outsize  = planesize * 3 + strlen("FRAME\n");
+    }
+    else if(len > 4 && !strcasecmp(filename + len - 4, ".png"))
+    {
+        dumpbase          = estrdup(filename);
+        dumpbase[len - 4] = '\0';
+        dumpsink          = VIDDUMP_PNG;
+        outsize           = planesize;
+    }
+    else
+    {
+        if(!(dumpfile = I_fopen(filename, "wb")))
+        {
+            usermsg("VidDump: couldn't open %s for writing", filename);
+            return;
+        }
+        dumpsink = VIDDUMP_RAW;
+        outsize  = planesize * 3;
+    }
+
+    numdumpworkers = emin(emax(int(std::thread::hardware_concurrency()) - 1, 1), MAXVIDDUMPWORKERS);
+    numdumpframes  = numdumpworkers * 2 + 2;
+
+    dumpframes  = ecalloc(viddumpframe_t *, numdumpframes, sizeof(viddumpframe_t));
+    dumpworkers = new viddumpworker_t[numdumpworkers];
+
+    for(int i = 0; i < numdumpframes; i++)
+        dumpframes[i].pixels = emalloc(byte *, planesize);
+
+    for(int i = 0; i < numdumpworkers; i++)
+    {
+        viddumpworker_t &worker = dumpworkers[i];
+
+        worker.out    = emalloc(byte *, outsize);
+        worker.thread = std::thread(M_vidDumpWorker, &worker);
+    }
+
+    // Until the game sets one
+    memcpy(basepal, wGlobalDir.cacheLumpName("PLAYPAL", PU_CACHE), sizeof(basepal));
+
+    I_AtExit(M_vidDumpFinish);
+
+    usermsg("VidDump: writing %dx%d frames to %s with %d threads", dumpwidth, dumpheight, filename, numdumpworkers);
+}
+
+//
+// M_VidDumpSetPalette
+//
+// Keeps the palette given to the video driver, before gamma.
+//
+void M_VidDumpSetPalette(const byte *palette)
+{
+    memcpy(basepal, palette, sizeof(basepal));
+}
+
+//
+// M_VidDumpFrame
+//
+// Queues a copy of the displayed frame. Only waits if every slot is still
+// taken by the workers.
+//
+void M_VidDumpFrame(const byte *screen, int width, int height, int pitch)
+{
+    if(!dumpframes)
+        return;
+
+    if(width != dumpwidth || height != dumpheight)
+    {
+        ++skippedframes;
+        return;
+    }
+
+    viddumpframe_t &frame = dumpframes[framessubmitted % numdumpframes];
+
+    {
+        std::unique_lock lock(dumpmutex);
+        slotfree.wait(lock, [&frame] { return !frame.inuse; });
+    }
+
+    // A free slot isn't touched by the workers, so it's filled unlocked
+    for(int x = 0; x < width; x++)
+        memcpy(frame.pixels + x * height, screen + x * pitch, height);
+
+    for(int i = 0; i < 768; i++)
+        frame.palette[i] = gammatable[usegamma][basepal[i]];
+
+    {
+        std::lock_guard lock(dumpmutex);
+        frame.number = framessubmitted++;
+        frame.inuse  = true;
+    }
+    jobready.notify_one();
+}
+
+// EOF
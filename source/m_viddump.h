@@ -0,0 +1,35 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Streaming a demo out as video with -viddump
+//
+
+#ifndef M_VIDDUMP_H__
+#define M_VIDDUMP_H__
+
+void M_VidDumpInit();
+void M_VidDumpSetPalette(const byte *palette);
+void M_VidDumpFrame(const byte *screen, int width, int height, int pitch);
+
+#endif
+
+// EOF
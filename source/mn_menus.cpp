@@ -1625,6 +1625,8 @@ static menuitem_t mn_video_items[] = {
     { it_info,     "Display Properties",     nullptr,             nullptr   },
     { it_toggle,   "Favorite screen mode",   "mn_favscreentype",  nullptr   },
     { it_toggle,   "Renderer threads",       "r_numcontexts",     nullptr   },
+    { it_toggle,   "Balance threads",        "r_balancecontexts", nullptr   },
+    { it_toggle,   "Parallel portals",       "r_parallelportals", nullptr   },
     { it_toggle,   "Display number",         "displaynum",        nullptr   },
     { it_toggle,   "Vertical sync",          "v_retrace",         nullptr   },
     { it_slider,   "Gamma correction",       "gamma",             nullptr   },
@@ -1660,6 +1662,9 @@ static menuitem_t mn_sysvideo_items[] = {
     { it_variable, "Opacity percentage",      "r_tranpct",      nullptr   },
     { it_toggle,   "Stock Doom object style", "r_tlstyle",      nullptr   },
     { it_toggle,   "Sprite projection style", "r_sprprojstyle", nullptr   },
+    { it_toggle,   "Slope subdivision",       "r_slopesubdiv",  nullptr   },
+    { it_toggle,   "Visibility culling",      "r_pvs",          nullptr   },
+    { it_toggle,   "Dynamic resolution",      "r_dynres",       nullptr   },
     { it_gap,      nullptr,                   nullptr,          nullptr   },
     { it_info,     "Framerate",               nullptr,          nullptr   },
     { it_toggle,   "Uncapped framerate",      "d_fastrefresh",  nullptr   },
@@ -1805,6 +1810,7 @@ static menuitem_t mn_vidadv_items[] = {
     { it_toggle,   "Texture filtering",    "gl_filter_type",     nullptr   },
     { it_toggle,   "Use extensions",       "gl_use_extensions",  nullptr   },
     { it_toggle,   "Use ARB pixelbuffers", "gl_arb_pixelbuffer", nullptr   },
+    { it_toggle,   "Threaded present",     "gl_presentthread",   nullptr   },
     { it_end,      nullptr,                nullptr,              nullptr   }
 };
 
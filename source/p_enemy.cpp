@@ -70,23 +70,143 @@ static Mobj *current_actor;
 // but some can be made preaware
 //
 
+//=============================================================================
 //
-// Called by P_NoiseAlert.
-// Recursively traverse adjacent sectors,
-// sound blocking lines cut off traversal.
+// Sound propagation graph
 //
-// killough 5/5/98: reformatted, cleaned up
+// Whether sound gets through a two-sided line only depends on the sectors on
+// either side, so it's remembered for each line and forgotten whenever one of
+// them moves. Each sector's two-sided lines are kept in one flat array along
+// with the sector beyond them, in the same order as sector_t::lines, so the
+// flood visits sectors exactly as it did when it walked the lines.
 //
-static void P_recursiveSound(sector_t *sec, const int soundblocks, Mobj *soundtarget)
+
+bool p_soundcache = true;
+
+struct soundedge_t
 {
-    // wake up all monsters in this sector
-    if(sec->validcount == validcount && sec->soundtraversed <= soundblocks + 1)
-        return; // already flooded
+    int line;  // index into lines
+    int other; // sector on the far side
+};
 
-    sec->validcount     = validcount;
-    sec->soundtraversed = soundblocks + 1;
-    P_SetTarget<Mobj>(&sec->soundtarget, soundtarget); // killough 11/98
+enum soundline_e : uint8_t
+{
+    SL_UNKNOWN, // needs checking
+    SL_OPEN,
+    SL_CLOSED,
+    SL_DYNAMIC, // depends on a polyobject or a sector beyond a portal; never cached
+};
+
+static soundedge_t  *soundedges;     // every sector's two-sided lines
+static int          *soundfirstedge; // numsectors + 1 offsets into soundedges
+static uint8_t      *soundlinestate; // soundline_e for each line
+static const line_t *soundlastline;  // the last line checked by a flood
+
+//
+// Builds the graph for the current level the first time it's needed.
+//
+static void P_buildSoundGraph()
+{
+    int numedges = 0;
+
+    for(int i = 0; i < numsectors; i++)
+    {
+        for(int j = 0; j < sectors[i].linecount; j++)
+        {
+            if(sectors[i].lines[j]->flags & ML_TWOSIDED)
+                ++numedges;
+        }
+    }
+
+    soundfirstedge = estructalloctag(int, numsectors + 1, PU_LEVEL);
+    soundedges     = estructalloctag(soundedge_t, emax(numedges, 1), PU_LEVEL);
+    soundlinestate = estructalloctag(uint8_t, emax(numlines, 1), PU_LEVEL);
+
+    numedges = 0;
+    for(int i = 0; i < numsectors; i++)
+    {
+        const sector_t *sec = &sectors[i];
+
+        soundfirstedge[i] = numedges;
+        for(int j = 0; j < sec->linecount; j++)
+        {
+            const line_t *check = sec->lines[j];
+            if(!(check->flags & ML_TWOSIDED))
+                continue;
+
+            soundedge_t &edge = soundedges[numedges++];
+            edge.line         = eindex(check - lines);
+            edge.other        = eindex(sides[check->sidenum[sides[check->sidenum[0]].sector == sec]].sector - sectors);
+        }
+    }
+    soundfirstedge[numsectors] = numedges;
+
+    for(int i = 0; i < numlines; i++)
+    {
+        const line_t &line = lines[i];
+        if(line.intflags & MLI_DYNASEGLINE || (line.intflags & MLI_1SPORTALLINE && line.beyondportalline))
+            soundlinestate[i] = SL_DYNAMIC;
+    }
+}
+
+//
+// P_ClearSoundGraph
+//
+// Forgets the graph of the old level.
+//
+void P_ClearSoundGraph()
+{
+    soundedges     = nullptr;
+    soundfirstedge = nullptr;
+    soundlinestate = nullptr;
+    soundlastline  = nullptr;
+}
+
+//
+// P_InvalidateSoundLines
+//
+// Called whenever a sector's floor or ceiling changes, so that its lines are
+// checked again the next time a sound reaches them.
+//
+void P_InvalidateSoundLines(const sector_t &sec)
+{
+    if(!soundlinestate)
+        return;
+
+    for(int i = 0; i < sec.linecount; i++)
+    {
+        uint8_t &state = soundlinestate[eindex(sec.lines[i] - lines)];
+        if(state != SL_DYNAMIC)
+            state = SL_UNKNOWN;
+    }
+}
 
+//
+// Returns true if sound can get through the opening of a two-sided line.
+//
+static bool P_soundCrossesLine(const line_t *check)
+{
+    uint8_t &state = soundlinestate[eindex(check - lines)];
+
+    soundlastline = check;
+
+    if(p_soundcache && (state == SL_OPEN || state == SL_CLOSED))
+        return state == SL_OPEN;
+
+    const bool open = P_LineOpening(check, nullptr).range > 0;
+    if(p_soundcache && state != SL_DYNAMIC)
+        state = open ? SL_OPEN : SL_CLOSED;
+
+    return open;
+}
+
+//
+// Calls visit for each sector sound can spread to from sec, in the order the
+// original line walk went through them.
+//
+template<typename F>
+static void P_soundNeighbors(sector_t *sec, const int soundblocks, F &&visit)
+{
     // Check the floor and ceiling portals
     for(surf_e surf : SURFS)
     {
@@ -96,19 +216,17 @@ static void P_recursiveSound(sector_t *sec, const int soundblocks, Mobj *soundta
         int        neighcount;
         const int *neighlist = P_GetSectorPortalNeighbors(*sec, surf, &neighcount);
         for(int i = 0; i < neighcount; ++i)
-            P_recursiveSound(&sectors[neighlist[i]], soundblocks, soundtarget);
+            visit(&sectors[neighlist[i]], soundblocks);
     }
 
-    for(int i = 0; i < sec->linecount; i++)
-    {
-        sector_t     *other;
-        const line_t *check = sec->lines[i];
-        if(!(check->flags & ML_TWOSIDED))
-            continue;
+    const int secnum = eindex(sec - sectors);
 
-        clip.open = P_LineOpening(check, nullptr);
+    for(int i = soundfirstedge[secnum]; i < soundfirstedge[secnum + 1]; i++)
+    {
+        const soundedge_t &edge  = soundedges[i];
+        const line_t      *check = &lines[edge.line];
 
-        if(clip.open.range <= 0)
+        if(!P_soundCrossesLine(check))
             continue; // closed door
 
         // Only for front-facing wall portals
@@ -124,18 +242,38 @@ static void P_recursiveSound(sector_t *sec, const int soundblocks, Mobj *soundta
 
             sector_t *iother = R_PointInSubsector(mid - nudge + v2fixed_t(check->portal->data.link.delta))->sector;
 
-            P_recursiveSound(iother, soundblocks, soundtarget);
+            visit(iother, soundblocks);
         }
 
-        other = sides[check->sidenum[sides[check->sidenum[0]].sector == sec]].sector;
-
         if(!(check->flags & ML_SOUNDBLOCK))
-            P_recursiveSound(other, soundblocks, soundtarget);
+            visit(&sectors[edge.other], soundblocks);
         else if(!soundblocks)
-            P_recursiveSound(other, 1, soundtarget);
+            visit(&sectors[edge.other], 1);
     }
 }
 
+//
+// Called by P_NoiseAlert.
+// Recursively traverse adjacent sectors,
+// sound blocking lines cut off traversal.
+//
+// killough 5/5/98: reformatted, cleaned up
+//
+static void P_recursiveSound(sector_t *sec, const int soundblocks, Mobj *soundtarget)
+{
+    // wake up all monsters in this sector
+    if(sec->validcount == validcount && sec->soundtraversed <= soundblocks + 1)
+        return; // already flooded
+
+    sec->validcount     = validcount;
+    sec->soundtraversed = soundblocks + 1;
+    P_SetTarget<Mobj>(&sec->soundtarget, soundtarget); // killough 11/98
+
+    P_soundNeighbors(sec, soundblocks, [soundtarget](sector_t *other, int blocks) {
+        P_recursiveSound(other, blocks, soundtarget);
+    });
+}
+
 //
 // Called by P_NoiseAlert.
 // Iteratively traverse adjacent sectors, sound blocking lines cut off traversal.
@@ -165,53 +303,7 @@ static void P_iterativeSound(sector_t *sec, const int soundblocks, Mobj *soundta
         sec->soundtraversed = soundblocks + 1;
         P_SetTarget<Mobj>(&sec->soundtarget, soundtarget); // killough 11/98
 
-        // Check the floor and ceiling portals
-        for(surf_e surf : SURFS)
-        {
-            if(!(sec->srf[surf].pflags & PS_PASSSOUND))
-                continue;
-
-            int        neighcount;
-            const int *neighlist = P_GetSectorPortalNeighbors(*sec, surf, &neighcount);
-            for(int i = 0; i < neighcount; ++i)
-                stack.add({ &sectors[neighlist[i]], soundblocks });
-        }
-
-        for(int i = 0; i < sec->linecount; i++)
-        {
-            sector_t     *other;
-            const line_t *check = sec->lines[i];
-            if(!(check->flags & ML_TWOSIDED))
-                continue;
-
-            clip.open = P_LineOpening(check, nullptr);
-
-            if(clip.open.range <= 0)
-                continue; // closed door
-
-            // Only for front-facing wall portals
-
-            // NOTE: edge portals don't need any handling, because the sound propagates through the
-            // expanded line opening naturally to the sector behind, after which it can propagate through
-            // the sector portal.
-            // FIXME: polyobject portal lines won't be found here unless the control sector is connected.
-            if(check->pflags & PS_PASSSOUND && check->frontsector == sec)
-            {
-                v2fixed_t mid   = { check->v1->x + check->dx / 2, check->v1->y + check->dy / 2 };
-                v2fixed_t nudge = P_GetSafeLineNormal(*check) / (1 << (FRACBITS - 8));
-
-                sector_t *iother = R_PointInSubsector(mid - nudge + v2fixed_t(check->portal->data.link.delta))->sector;
-
-                stack.add({ iother, soundblocks });
-            }
-
-            other = sides[check->sidenum[sides[check->sidenum[0]].sector == sec]].sector;
-
-            if(!(check->flags & ML_SOUNDBLOCK))
-                stack.add({ other, soundblocks });
-            else if(!soundblocks)
-                stack.add({ other, 1 });
-        }
+        P_soundNeighbors(sec, soundblocks, [&stack](sector_t *other, int blocks) { stack.add({ other, blocks }); });
     }
 }
 
@@ -223,11 +315,20 @@ static void P_iterativeSound(sector_t *sec, const int soundblocks, Mobj *soundta
 //
 void P_NoiseAlert(Mobj *target, Mobj *emitter)
 {
+    if(!soundedges)
+        P_buildSoundGraph();
+
     validcount++;
+    soundlastline = nullptr;
     if(demo_version >= 403)
         P_iterativeSound(emitter->subsector->sector, 0, target);
     else
         P_recursiveSound(emitter->subsector->sector, 0, target);
+
+    // The flood used to leave the opening of the last line it checked in
+    // clip.open, and code after it may still look there
+    if(soundlastline)
+        clip.open = P_LineOpening(soundlastline, nullptr);
 }
 
 //
@@ -1821,6 +1922,9 @@ static void P_ConsoleSummon(int type, angle_t an, int flagsmode, const char *fla
     newmobj->updateThinker();
 }
 
+VARIABLE_TOGGLE(p_soundcache, nullptr, onoff);
+CONSOLE_VARIABLE(p_soundcache, p_soundcache, 0) {}
+
 CONSOLE_COMMAND(summon, cf_notnet | cf_level | cf_hidden)
 {
     int         type;
@@ -30,6 +30,8 @@
 #include "info.h"
 #include "m_random.h"
 
+struct sector_t;
+
 enum
 {
     DI_EAST,
@@ -48,7 +50,8 @@ using dirtype_t = int;
 extern fixed_t xspeed[8];
 extern fixed_t yspeed[8];
 
-extern int p_lastenemyroar;
+extern int  p_lastenemyroar;
+extern bool p_soundcache;
 
 bool P_CheckMissileRange(Mobj *actor);
 bool P_HelpFriend(Mobj *actor);
@@ -60,6 +63,8 @@ void P_NewChaseDir(Mobj *actor);
 bool P_SmartMove(Mobj *actor);
 
 void P_NoiseAlert(Mobj *target, Mobj *emmiter);
+void P_ClearSoundGraph();
+void P_InvalidateSoundLines(const sector_t &sec);
 void P_SpawnBrainTargets(); // killough 3/26/98: spawn icon landings
 void P_SpawnSorcSpots();    // haleyjd 11/19/02: spawn dsparil spots
 
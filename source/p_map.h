@@ -68,6 +68,7 @@ static constexpr fixed_t STEPSIZE = 24 * FRACUNIT;
 
 extern int  spechits_emulation; // haleyjd 09/20/06
 extern bool donut_emulation;    // haleyjd 10/16/09
+extern bool p_sightcache;
 
 //=============================================================================
 //
@@ -146,6 +147,7 @@ bool P_TeleportMoveStrict(Mobj *thing, fixed_t x, fixed_t y, bool boss);
 //
 
 bool P_CheckSight(Mobj *t1, Mobj *t2);
+void P_ClearSightCache();
 void P_UseLines(player_t *player);
 
 // killough 8/2/98: add 'mask' argument to prevent friends autoaiming at others
@@ -240,52 +240,18 @@ public:
 
     // Data members
 
-    // More list: links in sector (if needed)
-    Mobj  *snext;
-    Mobj **sprev; // killough 8/10/98: change to ptr-to-ptr
-
-    // ioanch 20160109: sprite projection chains
-    DLListItem<spriteprojnode_t> *spriteproj;
-    sprojlast_t                   sprojlast; // coordinates after last check. Initially "invalid"
-
-    // More drawing info: to determine current sprite.
-    angle_t     angle;  // orientation
-    spritenum_t sprite; // used to find patch_t and flip value
-    int         frame;  // might be ORed with FF_FULLBRIGHT
-
-    // Interaction info, by BLOCKMAP.
-    // Links in blocks (if needed).
-    Mobj  *bnext;
-    Mobj **bprev; // killough 8/11/98: change to ptr-to-ptr
-
-    subsector_t *subsector;
-
-    // The closest interval over all contacted Sectors.
-    zrefs_t zref;
-
-    // For movement checking.
-    fixed_t radius;
-    fixed_t height;
+    // Fields touched every tic by thinking and movement come first, right
+    // after the PointThinker position, so that they share as few cache lines
+    // as possible. Rarely used ones follow them further down.
 
     // Momentums, used to update position.
     fixed_t momx;
     fixed_t momy;
     fixed_t momz;
 
-    // If == validcount, already checked.
-    int validcount;
-
-    mobjtype_t  type;
-    mobjinfo_t *info; // mobjinfo[mobj->type]
-
-    int colour;  // sf: the sprite colour
-    int tranmap; // the translucency map: MUST BE CACHED IF MODIFIED AT RUNTIME
-
-    // INVENTORY_FIXME: eliminate union
-    union
-    {
-        int bfgcount;
-    } extradata;
+    // For movement checking.
+    fixed_t radius;
+    fixed_t height;
 
     int          tics; // state tic counter
     state_t     *state;
@@ -297,15 +263,47 @@ public:
     int          intflags; // killough 9/15/98: internal flags
     int          health;
 
-    // Movement direction, movement generation (zig-zagging).
-    int16_t movedir;     // 0-7
-    int16_t movecount;   // when 0, select a new dir
-    int16_t strafecount; // killough 9/8/98: monster strafing
+    mobjtype_t  type;
+    mobjinfo_t *info; // mobjinfo[mobj->type]
+
+    // If == validcount, already checked.
+    int validcount;
+
+    subsector_t *subsector;
+
+    // The closest interval over all contacted Sectors.
+    zrefs_t zref;
+
+    // More list: links in sector (if needed)
+    Mobj  *snext;
+    Mobj **sprev; // killough 8/10/98: change to ptr-to-ptr
+
+    // Interaction info, by BLOCKMAP.
+    // Links in blocks (if needed).
+    Mobj  *bnext;
+    Mobj **bprev; // killough 8/11/98: change to ptr-to-ptr
+
+    // a linked list of sectors where this object appears
+    msecnode_t *touching_sectorlist; // phares 3/14/98
+
+    // Additional info record for player avatars only.
+    // Only valid if thing is a player
+    player_t *player;
 
     // Thing being chased/attacked (or nullptr),
     // also the originator for missiles.
     Mobj *target;
 
+    // More drawing info: to determine current sprite.
+    angle_t     angle;  // orientation
+    spritenum_t sprite; // used to find patch_t and flip value
+    int         frame;  // might be ORed with FF_FULLBRIGHT
+
+    // Movement direction, movement generation (zig-zagging).
+    int16_t movedir;     // 0-7
+    int16_t movecount;   // when 0, select a new dir
+    int16_t strafecount; // killough 9/8/98: monster strafing
+
     // Reaction time: if non 0, don't attack yet.
     // Used by player to freeze a bit after teleporting.
     int16_t reactiontime;
@@ -319,35 +317,49 @@ public:
 
     int16_t gear; // killough 11/98: used in torque simulation
 
-    // Additional info record for player avatars only.
-    // Only valid if thing is a player
-    player_t *player;
-    skin_t   *skin; // sf: skin
-
     // Player number last looked for.
     int16_t lastlook;
 
-    // For nightmare respawn.
-    mapthing_t spawnpoint;
-
-    // Thing being chased/attacked for tracers.
-    Mobj *tracer;
-
-    // new field: last known enemy -- killough 2/15/98
-    Mobj *lastenemy;
-
     // killough 8/2/98: friction properties part of sectors,
     // not objects -- removed friction properties from here
     // haleyjd 04/11/10: added back for compatibility code segments
     int friction;
     int movefactor;
 
-    // a linked list of sectors where this object appears
-    msecnode_t *touching_sectorlist;        // phares 3/14/98
+    fixed_t floorclip; // haleyjd 08/07/04: floor clip amount
+
+    prevpos_t prevpos; // previous position for interpolation
+
+    // Colder fields from here on.
+
     msecnode_t *old_sectorlist;             // haleyjd 04/16/10
     msecnode_t *sprite_touching_sectorlist; // for sprite rendering help
     msecnode_t *old_sprite_sectorlist;
 
+    // ioanch 20160109: sprite projection chains
+    DLListItem<spriteprojnode_t> *spriteproj;
+    sprojlast_t                   sprojlast; // coordinates after last check. Initially "invalid"
+
+    int colour;  // sf: the sprite colour
+    int tranmap; // the translucency map: MUST BE CACHED IF MODIFIED AT RUNTIME
+
+    // INVENTORY_FIXME: eliminate union
+    union
+    {
+        int bfgcount;
+    } extradata;
+
+    skin_t *skin; // sf: skin
+
+    // For nightmare respawn.
+    mapthing_t spawnpoint;
+
+    // Thing being chased/attacked for tracers.
+    Mobj *tracer;
+
+    // new field: last known enemy -- killough 2/15/98
+    Mobj *lastenemy;
+
     // SEE WARNING ABOVE ABOUT POINTER FIELDS!!!
 
     // New Fields for Eternity -- haleyjd
@@ -364,13 +376,9 @@ public:
     int damage;        // haleyjd 08/02/04: copy damage to mobj now
     int dropamount;    // haleyjd 08/05/13: for ammo drops, overrides ammoeffect
 
-    fixed_t floorclip; // haleyjd 08/07/04: floor clip amount
-
     float xscale; // haleyjd 11/22/09: x scaling
     float yscale; // haleyjd 11/22/09: y scaling
 
-    prevpos_t prevpos; // previous position for interpolation
-
     // scripting fields
     int      special;         // special
     int      args[NUMMTARGS]; // arguments
@@ -29,6 +29,8 @@
 #include "ev_specials.h"
 #include "m_bbox.h"
 #include "m_intmap.h"
+#include "p_enemy.h"
+#include "p_map.h"
 #include "p_chase.h"
 #include "polyobj.h"
 #include "p_portal.h"
@@ -1207,6 +1209,11 @@ void P_CheckRenderSectorPortalState(rendersector_t &sector, surf_e type)
 }
 void P_CheckSectorPortalState(sector_t &sector, surf_e type)
 {
+    // Called whenever a sector's height or portal changes, which sight checks
+    // made earlier in the tic didn't see
+    P_ClearSightCache();
+    P_InvalidateSoundLines(sector);
+
     surface_t &surface = sector.srf[type];
     if(!surface.portal)
     {
@@ -1222,6 +1229,8 @@ void P_CheckSectorPortalState(sector_t &sector, surf_e type)
 
 void P_CheckLPortalState(line_t *line)
 {
+    P_ClearSightCache();
+
     if(!line->portal)
     {
         line->pflags = 0;
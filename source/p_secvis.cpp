@@ -0,0 +1,644 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Sector-to-sector visibility worked out from the level's geometry,
+//  used to cull the BSP.
+//
+//  For every sector, the set of sectors that a straight line leaving it can
+//  reach through two-sided linedefs is worked out in the background when the
+//  level loads. The test is done in 2D and ignores everything that can block
+//  sight other than one-sided walls. The sets are saved along with the
+//  geometry they came from, so loading the same map again costs nothing.
+//
+//  The sets describe ideal geometry, not what the fixed-point sight traces
+//  over the map's own nodes will find, so they're only used for rendering
+//  and never decide anything in the game.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <math.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "z_zone.h"
+#include "d_main.h"
+#include "doomstat.h"
+#include "hal/i_directory.h"
+#include "i_system.h"
+#include "m_compare.h"
+#include "m_hash.h"
+#include "m_qstr.h"
+#include "p_portal.h"
+#include "p_secvis.h"
+#include "polyobj.h"
+#include "r_state.h"
+
+// Slack given to every clip, in map units, so rounding can't hide anything
+static constexpr double SECVIS_EPSILON = 1.0 / 16;
+
+// A sector which has to follow more sight chains than this through the map is
+// given up on, and taken to see everything
+static constexpr int SECVIS_MAXSTEPS = 1 << 18;
+static constexpr int SECVIS_MAXDEPTH = 1024;
+
+// The building threads are capped, as each keeps a copy of its chain state
+static constexpr int SECVIS_MAXTHREADS = 8;
+
+// Cache files, bumped whenever the sets could come out differently
+static constexpr char SECVIS_MAGIC[4] = { 'E', 'E', 'S', 'V' };
+static constexpr int  SECVIS_VERSION  = 2;
+
+// Limits on the cache: tables bigger than this aren't saved, and past this
+// many files the ones used least recently are deleted
+static constexpr size_t SECVIS_MAXCACHEBYTES = 32 * 1024 * 1024;
+static constexpr int    SECVIS_MAXCACHEFILES = 16;
+
+struct secvisseg_t
+{
+    double x1, y1, x2, y2;
+};
+
+// A two-sided linedef between two different sectors
+struct secvisportal_t
+{
+    secvisseg_t seg; // from v1 to v2, so the front sector is on the right
+    int         front, back;
+};
+
+//
+// A cache file is this header, then every portal the sets were built from as
+// a secviscacheportal_t, then the sets themselves
+//
+struct secviscacheheader_t
+{
+    char    magic[4];
+    int32_t version;
+    int32_t numsectors;
+    int32_t numportals;
+};
+
+struct secviscacheportal_t
+{
+    int32_t x1, y1, x2, y2; // fixed point, as in the map
+    int32_t front, back;
+};
+
+//
+// Everything the building threads work on, copied from the level so that
+// they never have to touch zone memory
+//
+struct secvisbuild_t
+{
+    int                           numsectors = 0;
+    std::vector<secvisportal_t>   portals;
+    std::vector<std::vector<int>> sectorportals; // portals touching each sector
+
+    size_t            rowbytes = 0;
+    std::vector<byte> bits; // a row of visible sectors per sector
+
+    std::vector<secviscacheportal_t> fingerprint; // the portals as saved with the sets
+    std::string                      cachepath;   // empty if there's nowhere to save the sets
+
+    std::atomic<int>  nextrow = 0;
+    std::atomic<bool> cancel  = false;
+    std::atomic<bool> done    = false;
+};
+
+// Sight chains being followed from one sector
+struct secvisflow_t
+{
+    secvisbuild_t    &build;
+    byte             *row;
+    std::vector<byte> onchain; // portals already crossed by the current chain
+    int               steps;
+    bool              overflow;
+};
+
+static secvisbuild_t *g_secvisbuild;
+static std::thread    g_secvisthread; // joined by P_ClearSecVis
+
+inline static void P_secVisMark(byte *row, int secnum)
+{
+    row[secnum >> 3] |= 1 << (secnum & 7);
+}
+
+inline static bool P_secVisTest(const byte *row, int secnum)
+{
+    return row[secnum >> 3] & (1 << (secnum & 7));
+}
+
+//
+// Signed distance of a point from a line, positive on its left
+//
+static double P_secVisSide(double lx1, double ly1, double lx2, double ly2, double x, double y)
+{
+    const double dx = lx2 - lx1, dy = ly2 - ly1;
+    const double len = sqrt(dx * dx + dy * dy);
+
+    if(len < SECVIS_EPSILON)
+        return 0.0;
+
+    return (dx * (y - ly1) - dy * (x - lx1)) / len;
+}
+
+//
+// Cuts a segment down to what lies on one side of a line. Returns false if
+// nothing is left.
+//
+static bool P_secVisClip(secvisseg_t &seg, double lx1, double ly1, double lx2, double ly2, bool keepleft)
+{
+    if(fabs(lx2 - lx1) < SECVIS_EPSILON && fabs(ly2 - ly1) < SECVIS_EPSILON)
+        return true; // no line to cut with
+
+    double d1 = P_secVisSide(lx1, ly1, lx2, ly2, seg.x1, seg.y1);
+    double d2 = P_secVisSide(lx1, ly1, lx2, ly2, seg.x2, seg.y2);
+    if(!keepleft)
+    {
+        d1 = -d1;
+        d2 = -d2;
+    }
+    d1 += SECVIS_EPSILON;
+    d2 += SECVIS_EPSILON;
+
+    if(d1 < 0 && d2 < 0)
+        return false;
+    if(d1 >= 0 && d2 >= 0)
+        return true;
+
+    const double t  = d1 / (d1 - d2);
+    const double ix = seg.x1 + t * (seg.x2 - seg.x1);
+    const double iy = seg.y1 + t * (seg.y2 - seg.y1);
+    if(d1 < 0)
+    {
+        seg.x1 = ix;
+        seg.y1 = iy;
+    }
+    else
+    {
+        seg.x2 = ix;
+        seg.y2 = iy;
+    }
+    return true;
+}
+
+inline static bool P_secVisClip(secvisseg_t &seg, const secvisseg_t &line, bool keepleft)
+{
+    return P_secVisClip(seg, line.x1, line.y1, line.x2, line.y2, keepleft);
+}
+
+//
+// Cuts a segment down to what a straight line through both source and pass
+// could reach. The limits are the lines through an end of each which have the
+// rest of source and pass on opposite sides.
+//
+static bool P_secVisClipToSeparators(secvisseg_t &seg, const secvisseg_t &source, const secvisseg_t &pass)
+{
+    const double spoints[2][2] = {
+        { source.x1, source.y1 },
+        { source.x2, source.y2 }
+    };
+    const double ppoints[2][2] = {
+        { pass.x1, pass.y1 },
+        { pass.x2, pass.y2 }
+    };
+
+    for(int i = 0; i < 2; i++)
+    {
+        for(int j = 0; j < 2; j++)
+        {
+            const double *s = spoints[i], *p = ppoints[j];
+            const double *os = spoints[i ^ 1], *op = ppoints[j ^ 1];
+
+            const double sside = P_secVisSide(s[0], s[1], p[0], p[1], os[0], os[1]);
+            const double pside = P_secVisSide(s[0], s[1], p[0], p[1], op[0], op[1]);
+
+            if(!((sside < -SECVIS_EPSILON && pside > SECVIS_EPSILON) ||
+                 (sside > SECVIS_EPSILON && pside < -SECVIS_EPSILON)))
+                continue;
+            if(!P_secVisClip(seg, s[0], s[1], p[0], p[1], pside > 0))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// Gets a portal's segment facing so that the sector entered through it from
+// the given one is on its left
+//
+static secvisseg_t P_secVisEnter(const secvisportal_t &portal, int fromsector)
+{
+    if(portal.front == fromsector)
+        return portal.seg;
+    return { portal.seg.x2, portal.seg.y2, portal.seg.x1, portal.seg.y1 };
+}
+
+//
+// Follows the chains of sight which come through source and then pass into
+// the given sector
+//
+static void P_secVisFlow(secvisflow_t &flow, const secvisseg_t &source, const secvisseg_t &pass, int secnum, int depth)
+{
+    if(depth > SECVIS_MAXDEPTH)
+    {
+        flow.overflow = true;
+        return;
+    }
+
+    for(const int portalnum : flow.build.sectorportals[secnum])
+    {
+        if(flow.overflow)
+            return;
+        if(flow.onchain[portalnum])
+            continue;
+        if(++flow.steps > SECVIS_MAXSTEPS || flow.build.cancel.load(std::memory_order_relaxed))
+        {
+            flow.overflow = true;
+            return;
+        }
+
+        const secvisportal_t &portal = flow.build.portals[portalnum];
+        const int             next   = portal.front == secnum ? portal.back : portal.front;
+
+        // The part of the portal which can be seen through everything so far
+        secvisseg_t target = P_secVisEnter(portal, secnum);
+        if(!P_secVisClip(target, pass, true) || !P_secVisClipToSeparators(target, source, pass))
+            continue;
+
+        // And the part of the source which can see it
+        secvisseg_t newsource = source;
+        if(!P_secVisClip(newsource, target, false) || !P_secVisClipToSeparators(newsource, target, pass))
+            continue;
+
+        P_secVisMark(flow.row, next);
+
+        flow.onchain[portalnum] = 1;
+        P_secVisFlow(flow, newsource, target, next, depth + 1);
+        flow.onchain[portalnum] = 0;
+    }
+}
+
+//
+// Works out the row of sectors visible from one sector
+//
+static void P_secVisBuildRow(secvisflow_t &flow, int secnum)
+{
+    const secvisbuild_t &build = flow.build;
+
+    flow.row      = &flow.build.bits[secnum * build.rowbytes];
+    flow.steps    = 0;
+    flow.overflow = false;
+
+    P_secVisMark(flow.row, secnum);
+
+    for(const int sourcenum : build.sectorportals[secnum])
+    {
+        const secvisportal_t &sourceportal = build.portals[sourcenum];
+        const int             sourcenext   = sourceportal.front == secnum ? sourceportal.back : sourceportal.front;
+        const secvisseg_t     sourceseg    = P_secVisEnter(sourceportal, secnum);
+
+        // Anything next door is visible
+        P_secVisMark(flow.row, sourcenext);
+
+        flow.onchain[sourcenum] = 1;
+        for(const int passnum : build.sectorportals[sourcenext])
+        {
+            if(flow.onchain[passnum])
+                continue;
+
+            const secvisportal_t &passportal = build.portals[passnum];
+            const int             passnext   = passportal.front == sourcenext ? passportal.back : passportal.front;
+
+            secvisseg_t passseg = P_secVisEnter(passportal, sourcenext);
+            secvisseg_t source  = sourceseg;
+            if(!P_secVisClip(passseg, source, true) || !P_secVisClip(source, passseg, false))
+                continue;
+
+            P_secVisMark(flow.row, passnext);
+
+            flow.onchain[passnum] = 1;
+            P_secVisFlow(flow, source, passseg, passnext, 1);
+            flow.onchain[passnum] = 0;
+
+            if(flow.overflow)
+                break;
+        }
+        flow.onchain[sourcenum] = 0;
+
+        if(flow.overflow)
+            break;
+    }
+
+    if(flow.overflow)
+        memset(flow.row, 0xff, build.rowbytes);
+}
+
+//
+// Deletes the cache files used least recently, once there are too many
+//
+static void P_secVisTrimCache(const std::filesystem::path &dir)
+{
+    std::vector<std::filesystem::directory_entry> files;
+    std::error_code                               ec;
+
+    for(const auto &entry : std::filesystem::directory_iterator(dir, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if(entry.is_regular_file(ec) && !name.compare(0, 7, "secvis-"))
+            files.push_back(entry);
+    }
+
+    if(int(files.size()) <= SECVIS_MAXCACHEFILES)
+        return;
+
+    std::sort(files.begin(), files.end(), [](const auto &a, const auto &b) {
+        std::error_code ec;
+        return a.last_write_time(ec) > b.last_write_time(ec);
+    });
+    for(size_t i = SECVIS_MAXCACHEFILES; i < files.size(); i++)
+        std::filesystem::remove(files[i].path(), ec);
+}
+
+//
+// Writes finished sets out for P_secVisLoadCache
+//
+static void P_secVisSaveCache(const secvisbuild_t &build)
+{
+    const secviscacheheader_t header = { { SECVIS_MAGIC[0], SECVIS_MAGIC[1], SECVIS_MAGIC[2], SECVIS_MAGIC[3] },
+                                         SECVIS_VERSION,
+                                         build.numsectors,
+                                         int32_t(build.fingerprint.size()) };
+
+    const size_t portalbytes = build.fingerprint.size() * sizeof(secviscacheportal_t);
+    if(build.cachepath.empty() || portalbytes + build.bits.size() > SECVIS_MAXCACHEBYTES)
+        return;
+
+    FILE *f;
+    if(!(f = I_fopen(build.cachepath.c_str(), "wb")))
+        return;
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok      = ok && (!portalbytes || fwrite(build.fingerprint.data(), portalbytes, 1, f) == 1);
+    ok      = ok && fwrite(build.bits.data(), 1, build.bits.size(), f) == build.bits.size();
+
+    // this runs off the main thread, so there's no console to complain to
+    if(fclose(f) || !ok)
+    {
+        remove(build.cachepath.c_str());
+        return;
+    }
+
+    P_secVisTrimCache(std::filesystem::path(build.cachepath).parent_path());
+}
+
+//
+// Loads sets saved for exactly the same geometry. Returns false, leaving the
+// build alone, if there aren't any.
+//
+static bool P_secVisLoadCache(secvisbuild_t &build)
+{
+    FILE *f;
+    if(build.cachepath.empty() || !(f = I_fopen(build.cachepath.c_str(), "rb")))
+        return false;
+
+    secviscacheheader_t              header;
+    std::vector<secviscacheportal_t> portals(build.fingerprint.size());
+
+    const size_t portalbytes = portals.size() * sizeof(secviscacheportal_t);
+
+    bool ok = fread(&header, sizeof(header), 1, f) == 1;
+    ok      = ok && !memcmp(header.magic, SECVIS_MAGIC, sizeof(header.magic)) && header.version == SECVIS_VERSION;
+    ok      = ok && header.numsectors == build.numsectors && header.numportals == int32_t(portals.size());
+    ok      = ok && (!portalbytes || fread(portals.data(), portalbytes, 1, f) == 1);
+    ok      = ok && (!portalbytes || !memcmp(portals.data(), build.fingerprint.data(), portalbytes));
+    ok      = ok && fread(build.bits.data(), 1, build.bits.size(), f) == build.bits.size() && fgetc(f) == EOF;
+
+    fclose(f);
+
+    // don't leave half a table behind
+    if(!ok)
+    {
+        std::fill(build.bits.begin(), build.bits.end(), byte(0));
+        return false;
+    }
+
+    // keep it from being the next one trimmed
+    std::error_code ec;
+    std::filesystem::last_write_time(build.cachepath, std::filesystem::file_time_type::clock::now(), ec);
+
+    return true;
+}
+
+//
+// Building thread. Each takes the next row that nobody has started on.
+//
+static void P_secVisThreadFunc(secvisbuild_t *build)
+{
+    secvisflow_t flow = { *build, nullptr, std::vector<byte>(build->portals.size()), 0, false };
+
+    int secnum;
+    while(!build->cancel.load(std::memory_order_relaxed) &&
+          (secnum = build->nextrow.fetch_add(1, std::memory_order_relaxed)) < build->numsectors)
+    {
+        P_secVisBuildRow(flow, secnum);
+    }
+}
+
+//
+// Background thread which loads the sets, or builds them with as many
+// helpers as make sense and saves them
+//
+static void P_secVisBuildFunc(secvisbuild_t *build)
+{
+    if(!P_secVisLoadCache(*build))
+    {
+        const int numthreads = emin(int(emax(std::thread::hardware_concurrency(), 1u)), SECVIS_MAXTHREADS);
+
+        std::vector<std::thread> helpers;
+        for(int i = 1; i < numthreads; i++)
+            helpers.emplace_back(P_secVisThreadFunc, build);
+
+        P_secVisThreadFunc(build);
+
+        for(std::thread &helper : helpers)
+            helper.join();
+
+        if(build->cancel.load(std::memory_order_relaxed))
+            return;
+
+        P_secVisSaveCache(*build);
+    }
+
+    build->done.store(true, std::memory_order_release);
+}
+
+//
+// Hashes the geometry the sets are built from, to name the cache file
+//
+static uint32_t P_secVisHash(const secvisbuild_t &build)
+{
+    HashData hash(HashData::CRC32);
+
+    const int32_t numsecs = build.numsectors;
+    hash.addData(reinterpret_cast<const uint8_t *>(&numsecs), sizeof(numsecs));
+    if(!build.fingerprint.empty())
+    {
+        hash.addData(reinterpret_cast<const uint8_t *>(build.fingerprint.data()),
+                     uint32_t(build.fingerprint.size() * sizeof(secviscacheportal_t)));
+    }
+
+    hash.wrapUp();
+    return hash.getDigestPart(0);
+}
+
+//
+// P_BuildSecVis
+//
+// Gets the sets for the level just loaded on their way, unless they already
+// are. P_SecVisRow has nothing to give until they're ready.
+//
+void P_BuildSecVis()
+{
+    static bool atexitset = false;
+
+    if(g_secvisbuild || !numsectors)
+        return;
+
+    if(!atexitset)
+    {
+        I_AtExit(P_ClearSecVis);
+        atexitset = true;
+    }
+
+    auto build        = new secvisbuild_t();
+    build->numsectors = numsectors;
+    build->rowbytes   = (numsectors + 7) / 8;
+    build->bits.resize(build->rowbytes * numsectors);
+    build->sectorportals.resize(numsectors);
+
+    // Polyobjects move, so their lines are no use here
+    std::vector<bool> polylines(numlines);
+    for(int i = 0; i < numPolyObjects; i++)
+    {
+        for(int j = 0; j < PolyObjects[i].numLines; j++)
+            polylines[PolyObjects[i].lines[j] - lines] = true;
+    }
+
+    for(int i = 0; i < numlines; i++)
+    {
+        const line_t &line = lines[i];
+        if(!line.backsector || line.backsector == line.frontsector || polylines[i])
+            continue;
+
+        secvisportal_t portal;
+        portal.seg   = { M_FixedToDouble(line.v1->x), M_FixedToDouble(line.v1->y), M_FixedToDouble(line.v2->x),
+                         M_FixedToDouble(line.v2->y) };
+        portal.front = int(line.frontsector - sectors);
+        portal.back  = int(line.backsector - sectors);
+
+        build->sectorportals[portal.front].push_back(int(build->portals.size()));
+        build->sectorportals[portal.back].push_back(int(build->portals.size()));
+        build->portals.push_back(portal);
+        build->fingerprint.push_back({ line.v1->x, line.v1->y, line.v2->x, line.v2->y, portal.front, portal.back });
+    }
+
+    if(userpath)
+    {
+        const qstring dir = qstring(userpath).pathConcatenate("secvis");
+        I_CreateDirectory(dir);
+
+        std::error_code ec;
+        if(std::filesystem::is_directory(dir.constPtr(), ec))
+        {
+            qstring filename;
+            filename.Printf(64, "secvis-%08x-%d.dat", P_secVisHash(*build), numsectors);
+            build->cachepath = qstring(dir).pathConcatenate(filename).constPtr();
+        }
+    }
+
+    g_secvisbuild  = build;
+    g_secvisthread = std::thread(P_secVisBuildFunc, build);
+}
+
+//
+// P_ClearSecVis
+//
+// Stops any build still going and drops the current sets.
+//
+void P_ClearSecVis()
+{
+    if(g_secvisthread.joinable())
+    {
+        g_secvisbuild->cancel.store(true, std::memory_order_relaxed);
+        g_secvisthread.join();
+    }
+
+    delete g_secvisbuild;
+    g_secvisbuild = nullptr;
+}
+
+//
+// P_SecVisRow
+//
+// Gets the sectors visible from a sector, one bit each, or nullptr if they
+// haven't been worked out yet.
+//
+const byte *P_SecVisRow(int secnum)
+{
+    if(!g_secvisbuild || !g_secvisbuild->done.load(std::memory_order_acquire))
+        return nullptr;
+
+    return &g_secvisbuild->bits[secnum * g_secvisbuild->rowbytes];
+}
+
+//
+// P_SecVisPointInSector
+//
+// Even-odd test of whether a point is really inside a sector, rather than in
+// the void past its walls.
+//
+bool P_SecVisPointInSector(const sector_t &sector, fixed_t x, fixed_t y)
+{
+    const double px = M_FixedToDouble(x), py = M_FixedToDouble(y);
+    bool         inside = false;
+
+    for(int i = 0; i < sector.linecount; i++)
+    {
+        const line_t *line = sector.lines[i];
+        if(line->frontsector == line->backsector)
+            continue;
+
+        const double x1 = M_FixedToDouble(line->v1->x), y1 = M_FixedToDouble(line->v1->y);
+        const double x2 = M_FixedToDouble(line->v2->x), y2 = M_FixedToDouble(line->v2->y);
+
+        if((y1 > py) != (y2 > py) && px < x1 + (py - y1) * (x2 - x1) / (y2 - y1))
+            inside = !inside;
+    }
+
+    return inside;
+}
+
+// EOF
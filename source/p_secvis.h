@@ -0,0 +1,41 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Sector-to-sector visibility worked out from the level's geometry,
+//  used to cull the BSP.
+//
+
+#ifndef P_SECVIS_H__
+#define P_SECVIS_H__
+
+#include "m_fixed.h"
+
+struct sector_t;
+
+void        P_BuildSecVis();
+void        P_ClearSecVis();
+const byte *P_SecVisRow(int secnum);
+bool        P_SecVisPointInSector(const sector_t &sector, fixed_t x, fixed_t y);
+
+#endif
+
+// EOF
@@ -64,17 +64,20 @@
 #include "p_portal.h"
 #include "p_portalblockmap.h"
 #include "p_scroll.h"
+#include "p_secvis.h"
 #include "p_setup.h"
 #include "p_skin.h"
 #include "p_slopes.h"
 #include "p_spec.h"
 #include "p_tick.h"
 #include "polyobj.h"
+#include "r_bsp.h"
 #include "r_context.h"
 #include "r_data.h"
 #include "r_defs.h"
 #include "r_dynseg.h"
 #include "r_main.h"
+#include "r_pvs.h"
 #include "r_sky.h"
 #include "r_things.h"
 #include "s_musinfo.h"
@@ -3481,6 +3484,12 @@ static void P_PreZoneFreeLevel()
     // haleyjd 05/16/08: clear dynamic segs
     R_ClearDynaSegs();
 
+    // stop working out visible sets for the old level
+    P_ClearSecVis();
+    P_ClearSightCache();
+    P_ClearSoundGraph();
+    R_ClearPVS();
+
     //==============================================
     // Playsim
 
@@ -3985,6 +3994,8 @@ void P_SetupLevel(WadDirectory *dir, const char *mapname, int playermask, skill_
     else
         camera = nullptr; // camera off
 
+    R_InitNodeProjections();
+    R_BuildPVS();
     R_RefreshContexts();
 
     // haleyjd 01/07/07: initialize ACS for Hexen maps
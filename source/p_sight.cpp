@@ -24,6 +24,8 @@
 #include "z_zone.h"
 #include "i_system.h"
 
+#include "c_io.h"
+#include "c_runcmd.h"
 #include "cam_sight.h"
 #include "d_gi.h"
 #include "doomstat.h"
@@ -317,14 +319,14 @@ static bool P_CrossBSPNode(int bspnum, los_t *los)
 }
 
 //
-// P_CheckSight
+// P_checkSight
 // Returns true
 //  if a straight line between t1 and t2 is unobstructed.
 // Uses REJECT.
 //
 // killough 4/20/98: cleaned up, made to use new LOS struct
 //
-bool P_CheckSight(Mobj *t1, Mobj *t2)
+static bool P_checkSight(Mobj *t1, Mobj *t2)
 {
     // VANILLA_HERETIC: both in modern and Heretic demo gameplay use CAM_CheckSight
     if(full_demo_version >= make_full_version(340, 24) || vanilla_heretic)
@@ -404,6 +406,108 @@ bool P_CheckSight(Mobj *t1, Mobj *t2)
     return P_CrossBSPNode(numnodes - 1, &los);
 }
 
+//=============================================================================
+//
+// Sight Cache
+//
+// A crowd of monsters checks sight against the same target many times a tic,
+// often from the same spots. The answer only depends on the two things'
+// positions and heights and on the level's geometry, so it's kept until the
+// end of the tic, or until a sector, polyobject, portal or blocking line
+// changes. Entries are keyed on exact positions rather than on subsectors,
+// so a hit always returns what the full check would have: demos stay in sync.
+//
+
+bool p_sightcache = true;
+
+static constexpr int SIGHTCACHE_SIZE = 4096; // power of two
+static constexpr int SIGHTKEY_SIZE   = 10;
+
+struct sightcacheentry_t
+{
+    int32_t  key[SIGHTKEY_SIZE];
+    unsigned epoch; // only good while it matches sightcacheepoch
+    bool     result;
+};
+
+static sightcacheentry_t sightcache[SIGHTCACHE_SIZE];
+static unsigned          sightcacheepoch = 1;
+
+static unsigned sightcachehits;
+static unsigned sightcachemisses;
+static unsigned sightcacheflushes;
+
+//
+// P_ClearSightCache
+//
+// Drops every cached sight check. Called at the start of each tic, and by
+// anything which changes what sight checks can see through.
+//
+void P_ClearSightCache()
+{
+    // entries from before a wraparound could come back to life
+    if(!++sightcacheepoch)
+    {
+        memset(sightcache, 0, sizeof(sightcache));
+        sightcacheepoch = 1;
+    }
+    ++sightcacheflushes;
+}
+
+//
+// P_CheckSight
+//
+// Returns true if a straight line between t1 and t2 is unobstructed, reusing
+// the answer for the same two positions from earlier in the tic.
+//
+bool P_CheckSight(Mobj *t1, Mobj *t2)
+{
+    if(!p_sightcache)
+        return P_checkSight(t1, t2);
+
+    const int32_t key[SIGHTKEY_SIZE] = { t1->x, t1->y, t1->z, t1->height, t1->groupid,
+                                         t2->x, t2->y, t2->z, t2->height, t2->groupid };
+
+    uint32_t hash = 2166136261u;
+    for(const int32_t word : key)
+        hash = (hash ^ uint32_t(word)) * 16777619u;
+
+    sightcacheentry_t &entry = sightcache[(hash ^ (hash >> 16)) & (SIGHTCACHE_SIZE - 1)];
+    if(entry.epoch == sightcacheepoch && !memcmp(entry.key, key, sizeof(key)))
+    {
+        ++sightcachehits;
+        return entry.result;
+    }
+
+    ++sightcachemisses;
+
+    memcpy(entry.key, key, sizeof(key));
+    entry.epoch  = sightcacheepoch;
+    entry.result = P_checkSight(t1, t2);
+
+    return entry.result;
+}
+
+VARIABLE_TOGGLE(p_sightcache, nullptr, onoff);
+CONSOLE_VARIABLE(p_sightcache, p_sightcache, 0)
+{
+    P_ClearSightCache();
+}
+
+CONSOLE_COMMAND(p_sightcachestats, 0)
+{
+    if(Console.argc && !Console.argv[0]->strCaseCmp("reset"))
+    {
+        sightcachehits = sightcachemisses = sightcacheflushes = 0;
+        return;
+    }
+
+    const unsigned total = sightcachehits + sightcachemisses;
+
+    C_Printf("Sight checks: %u\nHits: %u (%.1f%%)\nMisses: %u\nFlushes: %u\n", total, sightcachehits,
+             total ? 100.0 * sightcachehits / total : 0.0, sightcachemisses, sightcacheflushes);
+}
+
 //----------------------------------------------------------------------------
 //
 // $Log: p_sight.c,v $
@@ -34,6 +34,7 @@
 #include "i_system.h"
 #include "p_anim.h"
 #include "p_chase.h"
+#include "p_map.h"
 #include "p_saveg.h"
 #include "p_scroll.h"
 #include "p_sector.h"
@@ -150,6 +151,8 @@ void Thinker::addThinker()
 
 Thinker *Thinker::currentthinker;
 
+ZoneSlab Thinker::slab("Thinkers", PU_LEVEL);
+
 //
 // P_RemoveThinkerDelayed
 //
@@ -232,6 +235,9 @@ void Thinker::RunThinkers(void)
     mobileCrossLineActivations.makeEmpty();
     for(currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = currentthinker->next)
     {
+        // start loading the next one while this one thinks
+        E_PREFETCH(currentthinker->next);
+
         if(currentthinker->removed)
             currentthinker->removeDelayed();
         else
@@ -306,6 +312,9 @@ void P_Ticker()
     if(paused || ((menuactive || consoleactive) && !demoplayback && !netgame && players[consoleplayer].viewz != 1))
         return;
 
+    // sight checks are only cached within a tic
+    P_ClearSightCache();
+
     // spawn unknowns at start of map if requested and possible
     if(!leveltime)
         P_SpawnUnknownThings();
@@ -55,6 +55,9 @@ private:
     // Current position in list during RunThinkers
     static Thinker *currentthinker;
 
+    // Storage for every thinker, recycled as they come and go
+    static ZoneSlab slab;
+
 protected:
     // Virtual methods (overridables)
     virtual void Think() {}
@@ -78,7 +81,10 @@ public:
     {}
 
     // operator new, overriding ZoneObject::operator new (size_t)
-    void *operator new(size_t size) { return ZoneObject::operator new(size, PU_LEVEL); }
+    void *operator new(size_t size) { return ZoneObject::operator new(size, slab); }
+
+    // The virtual destructor makes sure size is that of the whole object
+    void operator delete(void *p, size_t size) { slab.free(p, size); }
 
     // Static functions
     static void InitThinkers();
@@ -757,6 +757,9 @@ static void Polyobj_linkToBlockmap(polyobj_t *po)
     if(po->flags & (POF_ISBAD | POF_LINKED))
         return;
 
+    // it's been moved, so sight checks through it have to be done again
+    P_ClearSightCache();
+
     // 2/26/06: start line box with values of first vertex, not MININT/MAXINT
     blockbox[BOXLEFT] = blockbox[BOXRIGHT] = po->vertices[0]->x;
     blockbox[BOXBOTTOM] = blockbox[BOXTOP] = po->vertices[0]->y;
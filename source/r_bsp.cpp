@@ -21,6 +21,8 @@
 // Authors: James Haley, Stephen McGranahan, Ioan Chera, Max Waine
 //
 
+#include <atomic>
+
 #include "z_zone.h"
 #include "i_system.h"
 
@@ -42,6 +44,7 @@
 #include "r_dynseg.h"
 #include "r_dynabsp.h"
 #include "r_portal.h"
+#include "r_pvs.h"
 #include "r_segs.h"
 #include "r_sky.h"
 #include "r_state.h"
@@ -126,6 +129,18 @@ VALLOCATION(solidsegs)
             buf               += CONTEXTSEGS;
         }
     }
+
+    // Portal contexts can be given any part of the view
+    for(int i = 0; i < r_numportalcontexts; i++)
+    {
+        rendercontext_t &basecontext = R_GetPortalContext(i);
+        bspcontext_t    &context     = basecontext.bspcontext;
+        const int        CONTEXTSEGS = w / 2 + 1;
+
+        context.solidsegs = basecontext.heap->calloc<cliprange_t>(CONTEXTSEGS * 2, sizeof(cliprange_t), PU_VALLOC,
+                                                                  nullptr);
+        context.addedsegs = context.solidsegs + CONTEXTSEGS;
+    }
 }
 
 static void R_addSolidSeg(bspcontext_t &context, int x1, int x2)
@@ -2856,17 +2871,50 @@ static constexpr int checkcoord[12][4] = // killough -- static const
 };
 
 //
-// Checks BSP node/subtree bounding box.
-// Returns true if some part of the bbox might be visible.
+// Per-frame projections of BSP node bounding boxes onto the screen, shared by all
+// contexts. The projection only depends on the viewpoint, so every context that
+// renders from the main view would otherwise compute the same result for the same
+// node. Each entry packs the frameid it was computed on into the upper 32 bits, the
+// first column (plus one) into the next 16, and the last column (plus one) into the
+// lower 16. Both columns range from -1 to MAX_SCREENWIDTH + 1, so the two largest
+// 16-bit values are free to mark boxes that are always or never visible.
 //
-static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bounds, const cliprange_t *const solidsegs,
-                        const fixed_t *const bspcoord) // killough 1/28/98: static
+static std::atomic<uint64_t> *g_nodeprojections = nullptr;
+
+static constexpr uint32_t PROJECTION_ALWAYSVISIBLE = 0xFFFE;
+static constexpr uint32_t PROJECTION_NEVERVISIBLE  = 0xFFFF;
+
+//
+// Allocates the node projections for the current level
+//
+void R_InitNodeProjections()
 {
-    int                boxpos, boxx, boxy;
-    fixed_t            x1, x2, y1, y2;
-    angle_t            angle1, angle2, span, tspan;
-    int                sx1, sx2;
-    const cliprange_t *start;
+    g_nodeprojections = ecalloctag(std::atomic<uint64_t> *, emax(numnodes, 1) * 2, sizeof(*g_nodeprojections),
+                                   PU_LEVEL, reinterpret_cast<void **>(&g_nodeprojections));
+    R_ClearNodeProjections();
+}
+
+//
+// Invalidates all node projections. Needs calling when frameid wraps around.
+//
+void R_ClearNodeProjections()
+{
+    if(!g_nodeprojections)
+        return;
+
+    for(int i = 0; i < emax(numnodes, 1) * 2; i++)
+        g_nodeprojections[i].store(0, std::memory_order_relaxed);
+}
+
+//
+// Projects a BSP node's bounding box onto the screen, from the given viewpoint.
+// Returns one of the PROJECTION_ values, or the packed first and last columns.
+//
+static uint32_t R_projectBBox(const viewpoint_t &viewpoint, const fixed_t *const bspcoord)
+{
+    int     boxpos, boxx, boxy;
+    fixed_t x1, x2, y1, y2;
+    angle_t angle1, angle2, span, tspan;
 
     // 0,0 | 1,0 | 2,0   |  0  |  1  |  2
     //  ---|-----|---    |  ---|-----|---
@@ -2881,7 +2929,7 @@ static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bou
 
     boxpos = (boxy << 2) + boxx;
     if(boxpos == 5)
-        return true;
+        return PROJECTION_ALWAYSVISIBLE;
 
     x1 = bspcoord[checkcoord[boxpos][0]];
     y1 = bspcoord[checkcoord[boxpos][1]];
@@ -2896,7 +2944,7 @@ static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bou
 
     // Sitting on a line?
     if(span >= ANG180)
-        return true;
+        return PROJECTION_ALWAYSVISIBLE;
 
     tspan = angle1 + clipangle;
     if(tspan > 2 * clipangle)
@@ -2905,7 +2953,7 @@ static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bou
 
         // Totally off the left edge?
         if(tspan >= span)
-            return false;
+            return PROJECTION_NEVERVISIBLE;
 
         angle1 = clipangle;
     }
@@ -2917,7 +2965,7 @@ static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bou
 
         // Totally off the left edge?
         if(tspan >= span)
-            return false;
+            return PROJECTION_NEVERVISIBLE;
 
         angle2 = 0 - clipangle;
     }
@@ -2927,8 +2975,48 @@ static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bou
     //  (adjacent pixels are touching).
     angle1 = (angle1 + ANG90) >> ANGLETOFINESHIFT;
     angle2 = (angle2 + ANG90) >> ANGLETOFINESHIFT;
-    sx1    = viewangletox[angle1];
-    sx2    = viewangletox[angle2];
+
+    return (uint32_t(viewangletox[angle1] + 1) << 16) | uint32_t(viewangletox[angle2] + 1);
+}
+
+//
+// Checks BSP node/subtree bounding box.
+// Returns true if some part of the bbox might be visible.
+//
+// killough 1/28/98: static
+static bool R_checkBBox(const viewpoint_t &viewpoint, const contextbounds_t &bounds, const cliprange_t *const solidsegs,
+                        const fixed_t *const bspcoord, std::atomic<uint64_t> *const projection)
+{
+    uint32_t           projected;
+    int                sx1, sx2;
+    const cliprange_t *start;
+
+    if(projection)
+    {
+        // Rendering from the main view, so another context may have done the work already
+        const uint64_t cached = projection->load(std::memory_order_relaxed);
+        if(uint32_t(cached >> 32) == frameid)
+            projected = uint32_t(cached);
+        else
+        {
+            projected = R_projectBBox(viewpoint, bspcoord);
+            projection->store((uint64_t(frameid) << 32) | projected, std::memory_order_relaxed);
+        }
+    }
+    else
+        projected = R_projectBBox(viewpoint, bspcoord);
+
+    if((projected >> 16) == PROJECTION_ALWAYSVISIBLE)
+        return true;
+    if((projected >> 16) == PROJECTION_NEVERVISIBLE)
+        return false;
+
+    sx1 = int(projected >> 16) - 1;
+    sx2 = int(projected & 0xFFFF) - 1;
+
+    // Entirely outside of this context's columns?
+    if(sx2 < bounds.startcolumn - 1 || sx1 > bounds.endcolumn)
+        return false;
 
     // SoM: To account for the rounding error of the old BSP system, I needed to
     // make adjustments.
@@ -3295,6 +3383,15 @@ void R_PreRenderBSP()
 //
 void R_RenderBSPNode(rendercontext_t &context, int bspnum)
 {
+    const viewpoint_t &mainview = r_globalcontext.view;
+
+    // Node projections can be shared between contexts when looking from the main view
+    const bool sharedprojections = g_nodeprojections && r_numcontexts > 1 && context.view.x == mainview.x &&
+                                   context.view.y == mainview.y && context.view.angle == mainview.angle;
+
+    // Portals look from elsewhere, so only the main view can be culled by the PVS
+    const bool usepvs = R_PVSActive() && !context.portalcontext.portalrender.active;
+
     while(!(bspnum & NF_SUBSECTOR)) // Found a subsector?
     {
         const node_t *bsp = &nodes[bspnum];
@@ -3307,8 +3404,14 @@ void R_RenderBSPNode(rendercontext_t &context, int bspnum)
 
         // Possibly divide back space.
 
-        if(!R_checkBBox(context.view, context.bounds, context.bspcontext.solidsegs, bsp->bbox[side ^= 1]))
+        side ^= 1;
+        if(usepvs && !R_PVSChildVisible(bsp->children[side]))
             return;
+        if(!R_checkBBox(context.view, context.bounds, context.bspcontext.solidsegs, bsp->bbox[side],
+                        sharedprojections ? &g_nodeprojections[bspnum * 2 + side] : nullptr))
+        {
+            return;
+        }
 
         bspnum = bsp->children[side];
     }
@@ -58,6 +58,8 @@ void R_ClearDrawSegs(bspcontext_t &context);
 
 void R_ForEachPolyNode(void (*func)(rpolynode_t *bsp));
 
+void R_InitNodeProjections();
+void R_ClearNodeProjections();
 void R_PreRenderBSP();
 void R_RenderBSPNode(rendercontext_t &context, int bspnum);
 
@@ -29,6 +29,7 @@
 //
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -45,6 +46,7 @@
 #include "r_draw.h"
 #include "r_main.h"
 #include "r_plane.h"
+#include "r_portal.h"
 #include "r_state.h"
 #include "v_misc.h"
 
@@ -130,8 +132,19 @@ struct renderdata_t
 
     const char      *errormessage;
     std::atomic_bool fatalerror;
+
+    // Load balancing
+    float share;     // fraction of the spare view columns given to this context
+    float frametime; // time taken to render the last frame, in seconds
 };
 
+// Contexts never shrink narrower than this unless the view is too small
+static constexpr int MINCONTEXTCOLUMNS = 16;
+
+// How much of the difference between the old and the ideal share is applied each frame.
+// Keeps the bounds from oscillating when a frame's timings are noisy.
+static constexpr float BALANCEDAMPING = 0.5f;
+
 #if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
 #define R_runData R_runDataInner
 #endif
@@ -145,6 +158,51 @@ static void R_runData(renderdata_t *data);
 static renderdata_t *renderdatas      = nullptr;
 static int           prev_numcontexts = 0;
 
+//
+// Portal windows handed out by one context to be rendered by the portal contexts
+//
+struct portalbatch_t
+{
+    const rendercontext_t *parent;
+    const portaltask_t    *tasks;
+    int                    numtasks;
+    std::atomic_int        nexttask;
+
+    std::condition_variable finished;
+    std::mutex              finishedmutex;
+    int                     pending; // portal threads still working on the batch
+};
+
+struct portaldata_t
+{
+    rendercontext_t  context;
+    std::thread      thread;
+    std::atomic_bool claimed; // set while a batch is using the context
+
+    std::condition_variable checkbatch;
+    std::mutex              checkmutex;
+    portalbatch_t          *batch;
+    bool                    shouldquit;
+
+    const char      *errormessage;
+    std::atomic_bool fatalerror;
+};
+
+// Each portal context has a full set of renderer buffers, so don't go overboard
+static constexpr int MAXPORTALCONTEXTS = 8;
+
+#if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
+#define R_runPortalTasks R_runPortalTasksInner
+#endif
+
+static void R_runPortalTasks(portaldata_t *data, portalbatch_t &batch);
+
+#if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
+#undef R_runPortalTasks
+#endif
+
+static portaldata_t *portaldatas = nullptr;
+
 //
 // Grabs a given render context
 //
@@ -153,6 +211,69 @@ rendercontext_t &R_GetContext(int index)
     return renderdatas[index].context;
 }
 
+//
+// Grabs a given portal context
+//
+rendercontext_t &R_GetPortalContext(int index)
+{
+    return portaldatas[index].context;
+}
+
+//
+// Sets a context's bounds to start at the given column and span numcolumns
+//
+static void R_setContextBounds(rendercontext_t &context, const int startcolumn, const int numcolumns)
+{
+    context.bounds.startcolumn  = startcolumn;
+    context.bounds.endcolumn    = startcolumn + numcolumns;
+    context.bounds.fstartcolumn = float(context.bounds.startcolumn);
+    context.bounds.fendcolumn   = float(context.bounds.endcolumn);
+    context.bounds.numcolumns   = numcolumns;
+}
+
+//
+// Lays the contexts out side by side across width columns according to their shares.
+// Every context gets at least MINCONTEXTCOLUMNS (or an equal split of the width if
+// that's smaller), and the remaining columns are divided by share.
+//
+static void R_applyContextShares(const int width)
+{
+    const int   mincolumns = emin(MINCONTEXTCOLUMNS, width / r_numcontexts);
+    const float spare      = float(width - mincolumns * r_numcontexts);
+
+    float cumulativeshare = 0.0f;
+    int   startcolumn     = 0;
+    for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
+    {
+        cumulativeshare += renderdatas[currentcontext].share;
+
+        int endcolumn;
+        if(currentcontext == r_numcontexts - 1)
+            endcolumn = width; // make sure rounding never leaves columns out
+        else
+            endcolumn = mincolumns * (currentcontext + 1) + int(roundf(cumulativeshare * spare));
+
+        endcolumn = emax(endcolumn, startcolumn + mincolumns);
+
+        R_setContextBounds(renderdatas[currentcontext].context, startcolumn, endcolumn - startcolumn);
+        startcolumn = endcolumn;
+    }
+}
+
+//
+// Splits width columns equally between all the contexts
+//
+static void R_resetContextShares(const int width)
+{
+    for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
+    {
+        renderdatas[currentcontext].share     = 1.0f / float(r_numcontexts);
+        renderdatas[currentcontext].frametime = 0.0f;
+    }
+
+    R_applyContextShares(width);
+}
+
 //
 // Frees up the context's heap, which frees /all/ data tied to the context
 //
@@ -187,6 +308,24 @@ void R_freeData(renderdata_t &data)
         data.thread.join();
 }
 
+//
+// Stops a portal context's thread and frees the context
+//
+static void R_freePortalData(portaldata_t &data)
+{
+    {
+        std::lock_guard lock(data.checkmutex);
+        data.shouldquit = true;
+        data.checkbatch.notify_one();
+    }
+
+    if(data.thread.joinable())
+        data.thread.join();
+
+    R_freeContext(data.context);
+    data.~portaldata_t();
+}
+
 //
 // Frees up all contexts (and renderdatas by way of R_freeData)
 //
@@ -194,6 +333,15 @@ void R_FreeContexts()
 {
     R_freeContext(r_globalcontext);
 
+    if(portaldatas)
+    {
+        for(int currentcontext = 0; currentcontext < r_numportalcontexts; currentcontext++)
+            R_freePortalData(portaldatas[currentcontext]);
+        efree(portaldatas);
+        portaldatas         = nullptr;
+        r_numportalcontexts = 0;
+    }
+
     if(renderdatas)
     {
         for(int currentcontext = 0; currentcontext < prev_numcontexts; currentcontext++)
@@ -230,6 +378,21 @@ static void R_runData(renderdata_t *data)
         data->fatalerror = true;
     }
 }
+
+//
+// Same again for portal threads
+//
+static void R_runPortalTasks(portaldata_t *data, portalbatch_t &batch)
+{
+    __try
+    {
+        R_runPortalTasksInner(data, batch);
+    }
+    __except(I_W32ExceptionHandler(GetExceptionInformation()))
+    {
+        data->fatalerror = true;
+    }
+}
 #endif
 
 //
@@ -262,6 +425,34 @@ static void R_contextThreadFunc(renderdata_t *data)
     data->checkframe.notify_one();
 }
 
+//
+// Waits for batches of portal windows to render, so that portal threads
+// don't need to be spawned for every batch
+//
+static void R_portalThreadFunc(portaldata_t *data)
+{
+    std::unique_lock lock(data->checkmutex);
+
+    while(!data->shouldquit)
+    {
+        data->checkbatch.wait(lock, [&data] { return data->batch || data->shouldquit; });
+        if(portalbatch_t *batch = data->batch)
+        {
+            data->batch = nullptr;
+            lock.unlock();
+
+            R_runPortalTasks(data, *batch);
+            {
+                std::lock_guard finishedlock(batch->finishedmutex);
+                if(!--batch->pending)
+                    batch->finished.notify_one();
+            }
+
+            lock.lock();
+        }
+    }
+}
+
 //
 // Allocates a context's PU_LEVEL data
 //
@@ -277,6 +468,36 @@ void R_AllocateContextLevelData(rendercontext_t &context)
         context.portalcontext.portalstates[i].poverlay = R_NewPlaneHash(*context.heap, 131);
 }
 
+//
+// Initialises the portal contexts, if r_parallelportals is on
+//
+static void R_initPortalContexts()
+{
+    if(!r_parallelportals)
+        return;
+
+    r_numportalcontexts = emin(int(emax(std::thread::hardware_concurrency(), 1u)), MAXPORTALCONTEXTS);
+    portaldatas         = estructalloc(portaldata_t, r_numportalcontexts);
+
+    for(int currentcontext = 0; currentcontext < r_numportalcontexts; currentcontext++)
+    {
+        portaldata_t    &data    = *new(&portaldatas[currentcontext]) portaldata_t();
+        rendercontext_t &context = data.context;
+
+        context.bufferindex = int16_t(r_numcontexts + currentcontext);
+        context.portaltask  = true;
+
+        context.heap = new ZoneHeap();
+
+        context.portalcontext.portalrender = { false, MAX_SCREENWIDTH, 0 };
+
+        if(numsectors && gamestate == GS_LEVEL)
+            R_AllocateContextLevelData(context);
+
+        data.thread = std::thread(&R_portalThreadFunc, &data);
+    }
+}
+
 //
 // Initialises all the render contexts
 //
@@ -286,6 +507,8 @@ void R_InitContexts(const int width)
 
     prev_numcontexts = r_numcontexts;
 
+    R_initPortalContexts();
+
     r_globalcontext                     = {};
     r_globalcontext.bufferindex         = -1;
     r_globalcontext.bounds.startcolumn  = 0;
@@ -308,7 +531,7 @@ void R_InitContexts(const int width)
 
     renderdatas = estructalloc(renderdata_t, r_numcontexts);
 
-    const float contextwidth = float(width) / float(r_numcontexts);
+    R_resetContextShares(width);
 
     for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
     {
@@ -316,12 +539,6 @@ void R_InitContexts(const int width)
 
         context.bufferindex = currentcontext;
 
-        context.bounds.fstartcolumn = roundf(float(currentcontext) * contextwidth);
-        context.bounds.fendcolumn   = roundf(float(currentcontext + 1) * contextwidth);
-        context.bounds.startcolumn  = int(roundf(context.bounds.fstartcolumn));
-        context.bounds.endcolumn    = int(roundf(context.bounds.fendcolumn));
-        context.bounds.numcolumns   = context.bounds.endcolumn - context.bounds.startcolumn;
-
         context.heap = new ZoneHeap();
 
         context.portalcontext.portalrender = { false, MAX_SCREENWIDTH, 0 }; // THREAD_FIXME: Adjust?
@@ -351,6 +568,9 @@ void R_RefreshContexts()
     if(!r_hascontexts)
         return;
 
+    for(int currentcontext = 0; currentcontext < r_numportalcontexts; currentcontext++)
+        R_AllocateContextLevelData(portaldatas[currentcontext].context);
+
     if(r_numcontexts == 1)
     {
         R_AllocateContextLevelData(r_globalcontext);
@@ -375,17 +595,48 @@ void R_UpdateContextBounds()
         return;
     }
 
-    const float contextwidth = float(viewwindow.width) / float(r_numcontexts);
+    R_resetContextShares(viewwindow.width);
+    R_UpdateContextOpenings(video.height);
+}
+
+//
+// Moves columns from the contexts that took longest to render the last frame to
+// the ones that finished early, so that all of them take roughly as long.
+//
+static void R_balanceContexts()
+{
+    if(!r_balancecontexts)
+        return;
+
+    // Columns rendered per second by each context, on the assumption that the cost
+    // of the scene is spread evenly within its current bounds
+    float totalrate = 0.0f;
     for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
     {
-        rendercontext_t &context = renderdatas[currentcontext].context;
+        const renderdata_t &data = renderdatas[currentcontext];
+        totalrate += float(data.context.bounds.numcolumns) / emax(data.frametime, 1e-6f);
+    }
 
-        context.bounds.fstartcolumn = roundf(float(currentcontext) * contextwidth);
-        context.bounds.fendcolumn   = roundf(float(currentcontext + 1) * contextwidth);
-        context.bounds.startcolumn  = int(roundf(context.bounds.fstartcolumn));
-        context.bounds.endcolumn    = int(roundf(context.bounds.fendcolumn));
-        context.bounds.numcolumns   = context.bounds.endcolumn - context.bounds.startcolumn;
+    if(totalrate <= 0.0f)
+        return;
+
+    float totalshare = 0.0f;
+    for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
+    {
+        renderdata_t &data = renderdatas[currentcontext];
+
+        const float rate        = float(data.context.bounds.numcolumns) / emax(data.frametime, 1e-6f);
+        const float targetshare = rate / totalrate;
+
+        data.share += (targetshare - data.share) * BALANCEDAMPING;
+        totalshare += data.share;
     }
+
+    for(int currentcontext = 0; currentcontext < r_numcontexts; currentcontext++)
+        renderdatas[currentcontext].share /= totalshare;
+
+    R_applyContextShares(viewwindow.width);
+    R_UpdateContextOpenings(video.height);
 }
 
 //
@@ -463,6 +714,8 @@ void R_RunContexts()
     I_SetErrorHandler(nullptr);
 
     R_checkForContextErrors();
+
+    R_balanceContexts();
 }
 
 #if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
@@ -474,6 +727,8 @@ void R_RunContexts()
 //
 static void R_runData(renderdata_t *data)
 {
+    const auto starttime = std::chrono::steady_clock::now();
+
     try
     {
         R_RenderViewContext(data->context);
@@ -482,6 +737,129 @@ static void R_runData(renderdata_t *data)
     {
         data->errormessage = errorMessage.duplicate();
     }
+
+    data->frametime = std::chrono::duration<float>(std::chrono::steady_clock::now() - starttime).count();
+}
+
+#if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
+#undef R_runData
+#endif
+
+#if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
+#define R_runPortalTasks R_runPortalTasksInner
+#endif
+
+//
+// Renders portal windows from a batch until there are none left, catching any
+// possible errors
+//
+static void R_runPortalTasks(portaldata_t *data, portalbatch_t &batch)
+{
+    rendercontext_t &context = data->context;
+
+    try
+    {
+        int index;
+        while((index = batch.nexttask.fetch_add(1)) < batch.numtasks)
+        {
+            const portaltask_t &task = batch.tasks[index];
+
+            R_setContextBounds(context, task.minx, task.maxx - task.minx + 1);
+            R_FitPortalOpenings(context.planecontext, *context.heap, context.bounds, video.height);
+            R_RenderPortalTask(context, *batch.parent, task);
+        }
+    }
+    catch(qstring &errorMessage)
+    {
+        data->errormessage = errorMessage.duplicate();
+    }
+}
+
+#if (EE_CURRENT_COMPILER == EE_COMPILER_MSVC) && !defined(_DEBUG)
+#undef R_runPortalTasks
+#endif
+
+//
+// Renders portal windows which don't share any columns on as many portal contexts as
+// can be claimed, with the calling thread taking part. Returns false without doing
+// anything if fewer than two contexts are free, as nothing would be gained.
+//
+bool R_RunPortalTasks(const rendercontext_t &parent, const portaltask_t *tasks, int numtasks)
+{
+    portaldata_t *claimed[MAXPORTALCONTEXTS];
+    int           numclaimed = 0;
+
+    for(int currentcontext = 0; currentcontext < r_numportalcontexts && numclaimed < numtasks; currentcontext++)
+    {
+        if(!portaldatas[currentcontext].claimed.exchange(true))
+            claimed[numclaimed++] = &portaldatas[currentcontext];
+    }
+
+    if(numclaimed < 2)
+    {
+        while(numclaimed)
+            claimed[--numclaimed]->claimed = false;
+        return false;
+    }
+
+    portalbatch_t batch;
+    batch.parent   = &parent;
+    batch.tasks    = tasks;
+    batch.numtasks = numtasks;
+    batch.nexttask = 0;
+    batch.pending  = numclaimed - 1;
+
+    // R_RunContexts has already installed it when there are several contexts
+    const bool sethandler = r_numcontexts == 1;
+    if(sethandler)
+        I_SetErrorHandler(R_handleContextError);
+
+    // The first claimed context is rendered with on this thread
+    for(int i = 1; i < numclaimed; i++)
+    {
+        std::lock_guard lock(claimed[i]->checkmutex);
+        claimed[i]->batch = &batch;
+        claimed[i]->checkbatch.notify_one();
+    }
+
+    R_runPortalTasks(claimed[0], batch);
+
+    {
+        std::unique_lock lock(batch.finishedmutex);
+        batch.finished.wait(lock, [&batch] { return !batch.pending; });
+    }
+
+    if(sethandler)
+        I_SetErrorHandler(nullptr);
+
+    bool    hasError = false;
+    qstring errorMessage{ "R_RunPortalTasks: Error in portal context(s):\n" };
+    for(int i = 0; i < numclaimed; i++)
+    {
+        portaldata_t &data = *claimed[i];
+
+        if(data.fatalerror)
+        {
+            I_FatalError(0, "Exception caught in R_RunPortalTasks: see CRASHLOG.TXT for info, and in the "
+                            "same directory please upload eternity.dmp along with the crash log\n");
+        }
+
+        if(data.errormessage)
+        {
+            errorMessage << "\t" << data.context.bufferindex << ": " << data.errormessage;
+            if(!errorMessage.endsWith('\n'))
+                errorMessage << "\n";
+
+            hasError = true;
+        }
+
+        data.claimed = false;
+    }
+
+    if(hasError)
+        I_Error("%s", errorMessage.constPtr());
+
+    return true;
 }
 
 VARIABLE_INT(r_numcontexts, nullptr, 0, UL, nullptr);
@@ -504,6 +882,23 @@ CONSOLE_VARIABLE(r_numcontexts, r_numcontexts, cf_buffered)
     I_SetMode();
 }
 
+VARIABLE_TOGGLE(r_parallelportals, nullptr, onoff);
+CONSOLE_VARIABLE(r_parallelportals, r_parallelportals, cf_buffered)
+{
+    I_SetMode();
+}
+
+VARIABLE_TOGGLE(r_balancecontexts, nullptr, onoff);
+CONSOLE_VARIABLE(r_balancecontexts, r_balancecontexts, 0)
+{
+    // Start over from an even split so toggling it gives a fair comparison
+    if(r_numcontexts > 1 && renderdatas)
+    {
+        R_resetContextShares(viewwindow.width);
+        R_UpdateContextOpenings(video.height);
+    }
+}
+
 //
 // True if conditions met to have thorough sprite collection when projecting them.
 //
@@ -40,6 +40,7 @@ struct drawnsprite_t;
 struct drawseg_t;
 struct drawsegs_xrange_t;
 struct maskedrange_t;
+struct portaltask_t;
 struct poststack_t;
 struct pwindow_t;
 struct sectorbox_t;
@@ -194,6 +195,9 @@ struct rendercontext_t
     contextbounds_t bounds;
     viewpoint_t     view;
     cbviewpoint_t   cb_view;
+
+    // Set for the contexts that render portal windows for the others
+    bool portaltask;
 };
 
 // The global context is for single-threaded things that still require a context
@@ -201,14 +205,20 @@ struct rendercontext_t
 inline rendercontext_t r_globalcontext;
 
 inline int  r_numcontexts;
-inline bool r_hascontexts = false; // Remains false if running in a scenario with no window.
+inline bool r_hascontexts     = false; // Remains false if running in a scenario with no window.
+inline bool r_balancecontexts = true;  // Resize contexts each frame based on how long they took to render
+inline bool r_parallelportals = false; // Render portal windows that don't share columns in parallel
+
+inline int r_numportalcontexts = 0; // Only nonzero while r_parallelportals is on
 
 rendercontext_t &R_GetContext(int context);
+rendercontext_t &R_GetPortalContext(int context);
 void             R_FreeContexts();
 void             R_InitContexts(const int width);
 void             R_RefreshContexts();
 void             R_UpdateContextBounds();
 void             R_RunContexts();
+bool             R_RunPortalTasks(const rendercontext_t &parent, const portaltask_t *tasks, int numtasks);
 
 template<typename F>
 void R_ForEachContext(F &&f)
@@ -223,6 +233,9 @@ void R_ForEachContext(F &&f)
         for(int i = 0; i < r_numcontexts; i++)
             f(R_GetContext(i));
     }
+
+    for(int i = 0; i < r_numportalcontexts; i++)
+        f(R_GetPortalContext(i));
 }
 
 bool R_NeedThoroughSpriteCollection();
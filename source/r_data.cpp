@@ -40,9 +40,11 @@
 #include "r_defs.h"
 #include "r_main.h"
 #include "r_patch.h"
+#include "r_ripple.h"
 #include "r_sky.h"
 #include "r_state.h"
 #include "v_misc.h"
+#include "v_palmatch.h"
 #include "v_patchfmt.h"
 #include "v_video.h"
 #include "w_wad.h"
@@ -278,6 +280,115 @@ int tran_filter_pct = 66; // filter percent
 
 #define TSC 12        /* number of fixed point digits in filter percent */
 
+//
+// Composes a default translucency filter map based on PLAYPAL, for
+// tran_filter_pct. Each entry is found with a nearest colour search over the
+// whole palette, which V_MatchColors does a row at a time.
+//
+static void R_buildTranMap(const byte *playpal, bool force)
+{
+    palmatch_t match;
+    int        pal_w1[3][256];
+
+    int w1 = ((unsigned int)tran_filter_pct << TSC) / 100;
+    int w2 = (1l << TSC) - w1;
+
+    // First, convert playpal into long int type, and transpose array,
+    // for fast inner-loop calculations. Precompute tot array.
+    {
+        int                  i = 255;
+        const unsigned char *p = playpal + 255 * 3;
+        do
+        {
+            int t, d;
+            pal_w1[0][i]  = (match.pal[0][i] = t = p[0]) * w1;
+            d             = t * t;
+            pal_w1[1][i]  = (match.pal[1][i] = t = p[1]) * w1;
+            d            += t * t;
+            pal_w1[2][i]  = (match.pal[2][i] = t = p[2]) * w1;
+            d            += t * t;
+            p            -= 3;
+            match.tot[i]  = d << (TSC - 1);
+        }
+        while(--i >= 0);
+    }
+
+    // Ties go to the highest colour, as they always have
+    match.preferhigh = true;
+
+    // Next, compute all entries using minimum arithmetic.
+    int   r[256], g[256], b[256];
+    byte *tp = main_tranmap;
+    for(int i = 0; i < 256; ++i, tp += 256)
+    {
+        int r1 = match.pal[0][i] * w2;
+        int g1 = match.pal[1][i] * w2;
+        int b1 = match.pal[2][i] * w2;
+
+        if(!(i & 31) && force)
+            V_LoadingIncrease(); // sf
+
+        for(int j = 0; j < 256; j++)
+        {
+            r[j] = pal_w1[0][j] + r1;
+            g[j] = pal_w1[1][j] + g1;
+            b[j] = pal_w1[2][j] + b1;
+        }
+
+        V_MatchColors(match, r, g, b, 256, tp);
+    }
+}
+
+//
+// Composes a default subtractive translucency map based on PLAYPAL.
+//
+static void R_buildSubMap(const byte *playpal)
+{
+    palmatch_t match;
+
+    // First, convert playpal into long int type, and transpose array,
+    // for fast inner-loop calculations. Precompute tot array.
+    {
+        int                  i = 255;
+        const unsigned char *p = playpal + 255 * 3;
+        do
+        {
+            int t, d;
+            match.pal[0][i] = t  = p[0];
+            d                    = t * t;
+            match.pal[1][i] = t  = p[1];
+            d                   += t * t;
+            match.pal[2][i] = t  = p[2];
+            d                   += t * t;
+            p                   -= 3;
+            match.tot[i]         = d / 2;
+        }
+        while(--i >= 0);
+    }
+
+    match.preferhigh = true;
+
+    // Next, compute all entries using minimum arithmetic.
+    int   r[256], g[256], b[256];
+    byte *tp = main_submap;
+    for(int i = 0; i < 256; i++, tp += 256)
+    {
+        int r1 = match.pal[0][i];
+        int g1 = match.pal[1][i];
+        int b1 = match.pal[2][i];
+
+        for(int j = 0; j < 256; j++)
+        {
+            // haleyjd: subtract and clamp to 0
+            r[j] = emax(r1 - match.pal[0][j], 0);
+            g[j] = emax(g1 - match.pal[1][j], 0);
+            b[j] = emax(b1 - match.pal[2][j], 0);
+        }
+
+        V_MatchColors(match, r, g, b, 256, tp);
+    }
+}
+
 //
 // R_InitTranMap
 //
@@ -342,59 +453,18 @@ void R_InitTranMap(bool force)
         prev_tran_pct = tran_filter_pct;
         memcpy(prev_palette, playpal, 768);
 
-        int pal[3][256], tot[256], pal_w1[3][256];
-        int w1 = ((unsigned int)tran_filter_pct << TSC) / 100;
-        int w2 = (1l << TSC) - w1;
-
-        // First, convert playpal into long int type, and transpose array,
-        // for fast inner-loop calculations. Precompute tot array.
+        if(V_LoadColorTable("tranmap", playpal, tran_filter_pct, main_tranmap, 256 * 256))
         {
-            int                  i = 255;
-            const unsigned char *p = playpal + 255 * 3;
-            do
+            if(force)
             {
-                int t, d;
-                pal_w1[0][i]  = (pal[0][i] = t = p[0]) * w1;
-                d             = t * t;
-                pal_w1[1][i]  = (pal[1][i] = t = p[1]) * w1;
-                d            += t * t;
-                pal_w1[2][i]  = (pal[2][i] = t = p[2]) * w1;
-                d            += t * t;
-                p            -= 3;
-                tot[i]        = d << (TSC - 1);
+                for(int i = 0; i < 8; i++)
+                    V_LoadingIncrease(); // sf
             }
-            while(--i >= 0);
         }
-
-        // Next, compute all entries using minimum arithmetic.
-        byte *tp = main_tranmap;
-        for(int i = 0; i < 256; ++i)
+        else
         {
-            int r1 = pal[0][i] * w2;
-            int g1 = pal[1][i] * w2;
-            int b1 = pal[2][i] * w2;
-
-            if(!(i & 31) && force)
-                V_LoadingIncrease(); // sf
-
-            for(int j = 0; j < 256; j++, tp++)
-            {
-                int color = 255;
-                int err;
-                int r    = pal_w1[0][j] + r1;
-                int g    = pal_w1[1][j] + g1;
-                int b    = pal_w1[2][j] + b1;
-                int best = INT_MAX;
-                do
-                {
-                    if((err = tot[color] - pal[0][color] * r - pal[1][color] * g - pal[2][color] * b) < best)
-                    {
-                        best = err;
-                        *tp  = color;
-                    }
-                }
-                while(--color >= 0);
-            }
+            R_buildTranMap(playpal, force);
+            V_SaveColorTable("tranmap", playpal, tran_filter_pct, main_tranmap, 256 * 256);
         }
     }
 }
@@ -456,55 +526,10 @@ void R_InitSubMap(bool force)
         prev_built    = true;
         memcpy(prev_palette, playpal, 768);
 
-        int pal[3][256], tot[256];
-
-        // First, convert playpal into long int type, and transpose array,
-        // for fast inner-loop calculations. Precompute tot array.
-        {
-            int                  i = 255;
-            const unsigned char *p = playpal + 255 * 3;
-            do
-            {
-                int t, d;
-                pal[0][i] = t = p[0];
-                d             = t * t;
-                pal[1][i] = t  = p[1];
-                d             += t * t;
-                pal[2][i] = t  = p[2];
-                d             += t * t;
-                p             -= 3;
-                tot[i]         = d / 2;
-            }
-            while(--i >= 0);
-        }
-
-        // Next, compute all entries using minimum arithmetic.
-        byte *tp = main_submap;
-        for(int i = 0; i < 256; i++)
+        if(!V_LoadColorTable("submap", playpal, 0, main_submap, 256 * 256))
         {
-            int r1 = pal[0][i];
-            int g1 = pal[1][i];
-            int b1 = pal[2][i];
-
-            for(int j = 0; j < 256; j++, tp++)
-            {
-                int color = 255;
-                int err;
-                // haleyjd: subtract and clamp to 0
-                int r    = emax(r1 - pal[0][j], 0);
-                int g    = emax(g1 - pal[1][j], 0);
-                int b    = emax(b1 - pal[2][j], 0);
-                int best = INT_MAX;
-                do
-                {
-                    if((err = tot[color] - pal[0][color] * r - pal[1][color] * g - pal[2][color] * b) < best)
-                    {
-                        best = err;
-                        *tp  = color;
-                    }
-                }
-                while(--color >= 0);
-            }
+            R_buildSubMap(playpal);
+            V_SaveColorTable("submap", playpal, 0, main_submap, 256 * 256);
         }
     }
 }
@@ -524,6 +549,7 @@ void R_InitData()
     R_InitColormaps();    // killough 3/20/98
     R_ClearSkyTextures(); // haleyjd  8/30/02
     R_InitTextures();
+    R_InitSwirlCache();
     R_InitSpriteLumps();
 
     if(general_translucency) // killough 3/1/98, 10/98
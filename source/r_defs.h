@@ -712,6 +712,7 @@ struct visplane_t
 {
     visplane_t               *next;     // Next visplane in hash chain -- killough
     int                       chainnum; // The index of this visplane's hash chain, for optimisation
+    unsigned int              hashkey;  // Hash of everything R_FindPlane compares, bar the slope
     int                       picnum, lightlevel, minx, maxx;
     fixed_t                   height;
     const lighttable_t *const (*colormap)[MAXLIGHTZ];
@@ -753,11 +754,26 @@ struct visplane_t
     angle_t viewangle;
 };
 
+// Entry in a planehash_t's lookup index
+struct planeslot_t
+{
+    visplane_t  *plane;
+    unsigned int hashkey;
+    unsigned int generation; // the entry is empty unless this matches the table's
+};
+
 struct planehash_t
 {
     int          chaincount;
     visplane_t **chains;
     planehash_t *next; // if this planehash is part of a reusable list
+
+    // Open-addressed index of the planes in the chains, so that R_FindPlane
+    // doesn't have to walk them. Bumping generation empties it.
+    int          slotcount; // always a power of 2
+    int          slotsused;
+    unsigned int generation;
+    planeslot_t *slots;
 };
 
 #endif
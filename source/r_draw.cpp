@@ -30,6 +30,7 @@
 #include "doomstat.h"
 #include "d_gi.h"
 #include "e_lib.h"
+#include "m_compare.h"
 #include "mn_engin.h"
 #include "r_draw.h"
 #include "r_main.h"
@@ -56,8 +57,9 @@
 //  and the total size == width*height*depth/8.,
 //
 
-rrect_t viewwindow;   // haleyjd 05/02/13
-rrect_t scaledwindow; // haleyjd 05/02/13
+rrect_t viewwindow;     // haleyjd 05/02/13
+rrect_t fullviewwindow; // viewwindow before dynamic resolution scaling
+rrect_t scaledwindow;   // haleyjd 05/02/13
 
 int   linesize = SCREENWIDTH; // killough 11/98
 byte *renderscreen;           // haleyjd
@@ -1215,6 +1217,124 @@ void CB_DrawAddTRColumn_8(cb_column_t &column)
 #undef SRCPIXEL
 #undef SRCPIXEL_MASK
 
+//==============================================================================
+//
+// Batched Column Drawers
+//
+// Opaque columns that are next to each other and share a colormap, texture
+// height and step (which is most of any wall, and every column of a sprite)
+// are held back and then drawn together. The setup is done once for all of
+// them, and each is then written down the framebuffer as one run, so the
+// columns fill neighbouring stretches of memory one after another.
+// Anything else that draws to the screen has to flush the batch first, which
+// the drawers below do for themselves; everything outside the column engine
+// calls ResetBuffer.
+//
+
+static constexpr int COLUMNBATCHSIZE = 4;
+
+struct columnbatch_t
+{
+    cb_column_t columns[COLUMNBATCHSIZE];
+    int         numcolumns;
+};
+
+// Each render context's thread keeps its own batch
+static thread_local columnbatch_t r_columnbatch;
+
+//
+// Draws all the columns held in the batch. Same results as CB_DrawColumn_8.
+//
+static void CB_FlushColumnBatch()
+{
+    columnbatch_t &batch = r_columnbatch;
+
+    if(batch.numcolumns < COLUMNBATCHSIZE)
+    {
+        // Not worth the effort for a partial batch
+        for(int i = 0; i < batch.numcolumns; i++)
+            CB_DrawColumn_8(batch.columns[i]);
+        batch.numcolumns = 0;
+        return;
+    }
+
+    const lighttable_t *const colormap   = batch.columns[0].colormap;
+    const fixed_t             fracstep   = batch.columns[0].step;
+    const int                 heightmask = batch.columns[0].texheight - 1;
+
+    for(int i = 0; i < COLUMNBATCHSIZE; i++)
+    {
+        const cb_column_t &column = batch.columns[i];
+        const byte *const  source = static_cast<const byte *>(column.source);
+
+        byte   *dest  = R_ADDRESS(column.x, column.y1);
+        fixed_t frac  = column.texmid + (int)((column.y1 - view.ycenter + 1) * fracstep);
+        int     count = column.y2 - column.y1 + 1;
+
+        while((count -= 2) >= 0)
+        {
+            dest[0]  = colormap[source[(frac >> FRACBITS) & heightmask]];
+            frac    += fracstep;
+            dest[1]  = colormap[source[(frac >> FRACBITS) & heightmask]];
+            frac    += fracstep;
+            dest    += 2;
+        }
+        if(count & 1)
+            *dest = colormap[source[(frac >> FRACBITS) & heightmask]];
+    }
+
+    batch.numcolumns = 0;
+}
+
+//
+// Adds a column to the batch, flushing it first if the column can't join it
+//
+static void CB_DrawColumnBatched_8(cb_column_t &column)
+{
+    columnbatch_t &batch = r_columnbatch;
+
+    if(column.y2 < column.y1)
+        return;
+
+#ifdef RANGECHECK
+    if(column.x < 0 || column.x >= video.width || column.y1 < 0 || column.y2 >= video.height)
+        I_Error("CB_DrawColumnBatched_8: %i to %i at %i\n", column.y1, column.y2, column.x);
+#endif
+
+    // Non-power-of-two textures need wrapping handled per pixel
+    if(column.texheight & (column.texheight - 1))
+    {
+        CB_FlushColumnBatch();
+        CB_DrawColumn_8(column);
+        return;
+    }
+
+    if(batch.numcolumns)
+    {
+        const cb_column_t &last = batch.columns[batch.numcolumns - 1];
+        if(column.x != last.x + 1 || column.colormap != last.colormap || column.step != last.step ||
+           column.texheight != last.texheight)
+        {
+            CB_FlushColumnBatch();
+        }
+    }
+
+    batch.columns[batch.numcolumns++] = column;
+    if(batch.numcolumns == COLUMNBATCHSIZE)
+        CB_FlushColumnBatch();
+}
+
+//
+// Flushes the batch before drawing a column some other way
+//
+template<R_ColumnFunc drawer>
+static void CB_DrawColumnUnbatched_8(cb_column_t &column)
+{
+    if(r_columnbatch.numcolumns)
+        CB_FlushColumnBatch();
+    drawer(column);
+}
+
 //
 // Normal Column Drawer Object
 // haleyjd 09/04/06
@@ -1245,6 +1365,35 @@ columndrawer_t r_normal_drawer = {
     },
 };
 
+//
+// Batched Column Drawer Object
+//
+columndrawer_t r_batched_drawer = {
+    CB_DrawColumnBatched_8,
+    CB_DrawColumnUnbatched_8<CB_DrawSkyColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawNewSkyColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawTLColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawTRColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawTLTRColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawFuzzColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawFlexColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawFlexTRColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawAddColumn_8>,
+    CB_DrawColumnUnbatched_8<CB_DrawAddTRColumn_8>,
+
+    CB_FlushColumnBatch,
+
+    {
+      // Normal                                           Translated
+        { CB_DrawColumnBatched_8,                          CB_DrawColumnUnbatched_8<CB_DrawTRColumn_8>     }, // NORMAL
+        { CB_DrawColumnUnbatched_8<CB_DrawFuzzColumn_8>,  CB_DrawColumnUnbatched_8<CB_DrawFuzzColumn_8>   }, // SHADOW
+        { CB_DrawColumnUnbatched_8<CB_DrawFlexColumn_8>,  CB_DrawColumnUnbatched_8<CB_DrawFlexTRColumn_8> }, // ALPHA
+        { CB_DrawColumnUnbatched_8<CB_DrawAddColumn_8>,   CB_DrawColumnUnbatched_8<CB_DrawAddTRColumn_8>  }, // ADD
+        { CB_DrawColumnUnbatched_8<CB_DrawTLColumn_8>,    CB_DrawColumnUnbatched_8<CB_DrawTLTRColumn_8>   }, // SUB
+        { CB_DrawColumnUnbatched_8<CB_DrawTLColumn_8>,    CB_DrawColumnUnbatched_8<CB_DrawTLTRColumn_8>   }, // TRANMAP
+    },
+};
+
 //
 // R_InitTranslationTables
 // Creates the translation tables to map
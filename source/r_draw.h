@@ -44,6 +44,7 @@ struct rrect_t
 
 extern rrect_t scaledwindow;
 extern rrect_t viewwindow;
+extern rrect_t fullviewwindow;
 
 // haleyjd 01/22/11: vissprite drawstyles
 enum
@@ -84,6 +85,7 @@ struct columndrawer_t
 };
 
 extern columndrawer_t r_normal_drawer;
+extern columndrawer_t r_batched_drawer;
 
 static constexpr int TRANSLATIONCOLOURS = 14;
 
@@ -0,0 +1,193 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Dynamic resolution scaling of the 3D view.
+//
+//  The time taken to render the view is tracked from frame to frame. When it
+//  runs over budget, the view is rendered into a smaller window in the corner
+//  of the real one, and then stretched back out over it before the status bar,
+//  HUD and console are drawn on top at full resolution. When there is time to
+//  spare again, the scale creeps back up to native.
+//
+
+#include <chrono>
+#include <math.h>
+
+#include "z_zone.h"
+#include "c_io.h"
+#include "c_runcmd.h"
+#include "m_compare.h"
+#include "r_draw.h"
+#include "r_dynres.h"
+#include "r_main.h"
+#include "v_video.h"
+
+bool r_dynres         = false;
+int  r_dynresbudget   = 12; // milliseconds
+int  r_dynresminscale = 50; // percent
+
+// Granularity of scale changes, in percent of each axis
+static constexpr int DYNRES_STEP = 5;
+
+// Frames to let the smoothed time catch up after a change before the next one
+static constexpr int DYNRES_SETTLEFRAMES = 8;
+
+// Weight given to the newest frame in the smoothed render time
+static constexpr float DYNRES_SMOOTHING = 0.2f;
+
+// Only scale back up once the view renders within this share of the budget
+static constexpr float DYNRES_HEADROOM = 0.7f;
+
+static int   dynresscale = 100; // percent of the full view window on each axis
+static float dynresavgms;       // smoothed render time
+static int   dynressettle;      // frames until the scale may change again
+
+static std::chrono::steady_clock::time_point dynresstart;
+
+// Source row for each row of the full view window
+static int *dynresrows;
+static int  dynresnumrows;
+
+//
+// Shrinks a freshly set up view window to the current scale, keeping its
+// top-left corner in place.
+//
+void R_ScaleViewWindow(rrect_t &window)
+{
+    if(dynresscale >= 100)
+        return;
+
+    window.width  = emax(1, window.width * dynresscale / 100);
+    window.height = emax(1, window.height * dynresscale / 100);
+}
+
+//
+// Stretches the view rendered into viewwindow out over fullviewwindow. This
+// works in place, from the bottom-right corner back, since no pixel is read
+// after its own spot in the full window has been written.
+//
+static void R_upscaleView()
+{
+    const int sw = viewwindow.width;
+    const int sh = viewwindow.height;
+    const int dw = fullviewwindow.width;
+    const int dh = fullviewwindow.height;
+
+    if(dh > dynresnumrows)
+    {
+        dynresrows    = erealloc(int *, dynresrows, dh * sizeof(int));
+        dynresnumrows = dh;
+    }
+    for(int y = 0; y < dh; y++)
+        dynresrows[y] = int(int64_t(y) * sh / dh);
+
+    byte *const base = renderscreen + fullviewwindow.y + linesize * fullviewwindow.x;
+
+    int lastsrcx = -1;
+    for(int x = dw - 1; x >= 0; x--)
+    {
+        const int srcx = int(int64_t(x) * sw / dw);
+        byte     *dest = base + linesize * x;
+
+        // Columns stretched from the same source column come out the same
+        if(srcx == lastsrcx)
+        {
+            memcpy(dest, dest + linesize, dh);
+            continue;
+        }
+
+        const byte *src = base + linesize * srcx;
+        for(int y = dh - 1; y >= 0; y--)
+            dest[y] = src[dynresrows[y]];
+
+        lastsrcx = srcx;
+    }
+}
+
+//
+// Called before the view is rendered. Adjusts the scale to the recent render
+// times, and starts timing this frame.
+//
+void R_StartDynamicResolution()
+{
+    int scale = dynresscale;
+
+    if(!r_dynres)
+        scale = 100;
+    else if(!dynressettle)
+    {
+        const float budget = float(r_dynresbudget);
+
+        if(dynresavgms > budget)
+        {
+            // The cost goes with the area, so aim for the square root straight away
+            const int target = int(dynresscale * sqrtf(budget / dynresavgms)) / DYNRES_STEP * DYNRES_STEP;
+            scale            = emin(target, dynresscale - DYNRES_STEP);
+        }
+        else if(dynresavgms < budget * DYNRES_HEADROOM)
+            scale = dynresscale + DYNRES_STEP;
+
+        scale = eclamp(scale, r_dynresminscale, 100);
+    }
+
+    if(scale != dynresscale)
+    {
+        dynresscale  = scale;
+        dynressettle = DYNRES_SETTLEFRAMES;
+        R_ExecuteSetViewSize();
+    }
+
+    dynresstart = std::chrono::steady_clock::now();
+}
+
+//
+// Called once the view, player sprites included, has been rendered. Scales
+// the view up to the full window and records how long it all took.
+//
+void R_FinishDynamicResolution()
+{
+    if(viewwindow.width != fullviewwindow.width || viewwindow.height != fullviewwindow.height)
+        R_upscaleView();
+
+    const float ms  = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - dynresstart).count();
+    dynresavgms    += (ms - dynresavgms) * DYNRES_SMOOTHING;
+
+    if(dynressettle)
+        --dynressettle;
+}
+
+VARIABLE_TOGGLE(r_dynres, nullptr, onoff);
+CONSOLE_VARIABLE(r_dynres, r_dynres, 0) {}
+
+VARIABLE_INT(r_dynresbudget, nullptr, 1, 100, nullptr);
+CONSOLE_VARIABLE(r_dynresbudget, r_dynresbudget, 0) {}
+
+VARIABLE_INT(r_dynresminscale, nullptr, 25, 100, nullptr);
+CONSOLE_VARIABLE(r_dynresminscale, r_dynresminscale, 0) {}
+
+CONSOLE_COMMAND(r_dynresstats, 0)
+{
+    C_Printf("Scale: %d%% (%dx%d of %dx%d)\nRender time: %.2f ms (budget %d ms)\n", dynresscale, viewwindow.width,
+             viewwindow.height, fullviewwindow.width, fullviewwindow.height, dynresavgms, r_dynresbudget);
+}
+
+// EOF
@@ -0,0 +1,41 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Dynamic resolution scaling of the 3D view.
+//
+
+#ifndef R_DYNRES_H__
+#define R_DYNRES_H__
+
+struct rrect_t;
+
+void R_ScaleViewWindow(rrect_t &window);
+void R_StartDynamicResolution();
+void R_FinishDynamicResolution();
+
+extern bool r_dynres;
+extern int  r_dynresbudget;
+extern int  r_dynresminscale;
+
+#endif
+
+// EOF
@@ -53,11 +53,13 @@
 #include "r_context.h"
 #include "r_draw.h"
 #include "r_dynabsp.h"
+#include "r_dynres.h"
 #include "r_dynseg.h"
 #include "r_interpolate.h"
 #include "r_main.h"
 #include "r_plane.h"
 #include "r_portal.h"
+#include "r_pvs.h"
 #include "r_ripple.h"
 #include "r_things.h"
 #include "r_segs.h"
@@ -146,8 +148,9 @@ columndrawer_t *r_column_engine;
 int             r_column_engine_num;
 
 static columndrawer_t *r_column_engines[NUMCOLUMNENGINES] = {
-    &r_normal_drawer, // normal engine
-                      // Here lies Quad Cache Engine: 2006/09/04 - 2020/10/31
+    &r_normal_drawer,  // normal engine
+                       // Here lies Quad Cache Engine: 2006/09/04 - 2020/10/31
+    &r_batched_drawer, // batched engine
 };
 
 //
@@ -618,6 +621,8 @@ void R_SetupViewScaling()
 
     // haleyjd 05/02/13: set viewwindow properties
     viewwindow.viewFromScaled(setblocks, video.width, video.height, scaledwindow);
+    fullviewwindow = viewwindow;
+    R_ScaleViewWindow(viewwindow);
 
     centerx     = viewwindow.width / 2;
     centery     = viewwindow.height / 2;
@@ -654,10 +659,14 @@ static void R_calculateVisSpriteScales()
     if(setblocks < 10)
     {
         float sbheight = GameModeInfo->StatusBar->height * video.yscalef;
-        swxscale       = (float)viewwindow.width / video.width;
-        swyscale       = (float)viewwindow.height / (video.height - sbheight);
+        swxscale       = (float)fullviewwindow.width / video.width;
+        swyscale       = (float)fullviewwindow.height / (video.height - sbheight);
     }
 
+    // dynamic resolution shrinks everything drawn into the view alike
+    swxscale *= (float)viewwindow.width / fullviewwindow.width;
+    swyscale *= (float)viewwindow.height / fullviewwindow.height;
+
     view.pspritexscale = realxscale * swxscale;
     view.pspriteyscale = realyscale * swyscale;
     view.pspriteystep  = 1.0f / view.pspriteyscale;
@@ -762,6 +771,7 @@ static void R_incrementFrameid()
             sectorboxvisit_t *visitids = context.portalcontext.visitids;
             memset(visitids, 0, sizeof(*visitids) * numsectors);
         });
+        R_ClearNodeProjections();
     }
 }
 
@@ -1168,6 +1178,7 @@ static void R_SetupFrame(player_t *player, camera_t *camera)
 
     viewpoint.sector = view.boomcolorsector;
 
+    R_SetupPVS(viewpoint);
     R_SetupSolidSegs();
     R_PreRenderBSP();
 
@@ -1384,6 +1395,10 @@ void R_RenderViewContext(rendercontext_t &context)
     // Draw Post-BSP elements such as sprites, masked textures, and portal
     // overlays
     R_DrawPostBSP(context);
+
+    // Columns held back by this context's thread need drawing before it finishes
+    if(r_column_engine->ResetBuffer)
+        r_column_engine->ResetBuffer();
 }
 
 static int render_ticker = 0;
@@ -1398,6 +1413,8 @@ void R_RenderPlayerView(player_t *player, camera_t *camerapoint)
     bool         quake      = false;
     unsigned int savedflags = 0;
 
+    R_StartDynamicResolution();
+
     R_SetupFrame(player, camerapoint);
 
     // Untaint and clear portals
@@ -1438,6 +1455,8 @@ void R_RenderPlayerView(player_t *player, camera_t *camerapoint)
     if(r_column_engine->ResetBuffer)
         r_column_engine->ResetBuffer();
 
+    R_FinishDynamicResolution();
+
     // haleyjd: remove sector interpolations
     if(view.lerp != FRACUNIT)
     {
@@ -1616,12 +1635,13 @@ void R_DoomTLStyle()
 // Console Commands
 //
 
-static const char *handedstr[]  = { "right", "left" };
-static const char *ptranstr[]   = { "none", "smooth", "general" };
-static const char *coleng[]     = { "normal" };
-static const char *spaneng[]    = { "highprecision" };
-static const char *tlstylestr[] = { "opaque", "boom", "additive" };
-static const char *sprprojstr[] = { "default", "fast", "thorough" };
+static const char *handedstr[]   = { "right", "left" };
+static const char *ptranstr[]    = { "none", "smooth", "general" };
+static const char *coleng[]      = { "normal", "batched" };
+static const char *spaneng[]     = { "highprecision" };
+static const char *tlstylestr[]  = { "opaque", "boom", "additive" };
+static const char *sprprojstr[]  = { "default", "fast", "thorough" };
+static const char *slopesubstr[] = { "8", "16" };
 
 // clang-format off
 
@@ -1636,6 +1656,7 @@ VARIABLE_BOOLEAN(r_swirl,              nullptr, onoff);
 VARIABLE_BOOLEAN(general_translucency, nullptr, onoff);
 VARIABLE_BOOLEAN(autodetect_hom,       nullptr, yesno);
 VARIABLE_TOGGLE(r_boomcolormaps,       nullptr, onoff)
+VARIABLE_TOGGLE(r_radixsort,           nullptr, onoff);
 
 // SoM: Variable FOV
 VARIABLE_INT(fov, nullptr, 20, 179, nullptr);
@@ -1651,6 +1672,7 @@ VARIABLE_INT(r_column_engine_num, nullptr, 0, NUMCOLUMNENGINES - 1,   coleng);
 VARIABLE_INT(r_span_engine_num,   nullptr, 0, NUMSPANENGINES - 1,     spaneng);
 VARIABLE_INT(r_tlstyle,           nullptr, 0, R_TLSTYLE_NUM - 1,      tlstylestr);
 VARIABLE_INT(r_sprprojstyle,      nullptr, 0, R_SPRPROJSTYLE_NUM - 1, sprprojstr);
+VARIABLE_INT(r_slopesubdiv,       nullptr, 0, R_SLOPESUBDIV_NUM - 1,  slopesubstr);
 
 // clang-format on
 
@@ -1761,6 +1783,8 @@ CONSOLE_VARIABLE(r_sprprojstyle, r_sprprojstyle, 0)
 }
 
 CONSOLE_VARIABLE(r_boomcolormaps, r_boomcolormaps, 0) {}
+CONSOLE_VARIABLE(r_radixsort, r_radixsort, 0) {}
+CONSOLE_VARIABLE(r_slopesubdiv, r_slopesubdiv, 0) {}
 
 CONSOLE_COMMAND(r_changesky, 0)
 {
@@ -85,6 +85,16 @@ enum
 
 inline int r_sprprojstyle;
 
+// Pixels between exact divides on sloped planes
+enum
+{
+    R_SLOPESUBDIV_8,
+    R_SLOPESUBDIV_16,
+    R_SLOPESUBDIV_NUM
+};
+
+inline int r_slopesubdiv = R_SLOPESUBDIV_16;
+
 //
 // Utility functions.
 //
@@ -148,7 +158,7 @@ angle_t R_WadToAngle(int wadangle);
 
 extern int viewdir;
 
-static constexpr int NUMCOLUMNENGINES = 1;
+static constexpr int NUMCOLUMNENGINES = 2;
 static constexpr int NUMSPANENGINES   = 1;
 
 extern int             r_column_engine_num;
@@ -64,6 +64,11 @@
 
 #define MAINHASHCHAINS 1021 // prime numbers are good for hashes with modulo-based functions
 
+// Size of a plane hash's lookup index, relative to its chain count
+static constexpr int PLANESLOTSPERCHAIN = 4;
+
+static void R_initPlaneHashIndex(ZoneHeap &heap, planehash_t &table, int tag);
+
 //
 // VALLOCATION(mainhash)
 //
@@ -84,6 +89,7 @@ VALLOCATION(mainhash)
 
         context.mainchains = heap.calloc<visplane_t *>(MAINHASHCHAINS, sizeof(visplane_t *), PU_VALLOC, nullptr);
         context.mainhash   = { MAINHASHCHAINS, context.mainchains, nullptr };
+        R_initPlaneHashIndex(heap, context.mainhash, PU_VALLOC);
     });
 }
 
@@ -95,6 +101,25 @@ constexpr unsigned int visplane_hash(const unsigned int picnum, const unsigned i
     return ((picnum * 3) + lightlevel + (height * 7)) % chains;
 }
 
+inline static unsigned int R_mixPlaneHash(unsigned int hash, unsigned int value)
+{
+    return hash ^ (value + 0x9e3779b9u + (hash << 6) + (hash >> 2));
+}
+
+inline static unsigned int R_mixPlaneHash(unsigned int hash, float value)
+{
+    unsigned int bits = 0;
+    if(value != 0.0f) // so that -0 hashes the same as 0, as they compare equal
+        memcpy(&bits, &value, sizeof(bits));
+    return R_mixPlaneHash(hash, bits);
+}
+
+inline static unsigned int R_mixPlaneHash(unsigned int hash, const void *value)
+{
+    const uintptr_t bits = reinterpret_cast<uintptr_t>(value);
+    return R_mixPlaneHash(R_mixPlaneHash(hash, unsigned(bits)), unsigned(uint64_t(bits) >> 32));
+}
+
 static float *g_openings = nullptr;
 static float *g_skews    = nullptr;
 
@@ -106,24 +131,78 @@ VALLOCATION(openings)
     g_openings = ecalloctag(float *, w *h, sizeof(float), PU_VALLOC, nullptr);
     g_skews    = ecalloctag(float *, w *h, sizeof(float), PU_VALLOC, nullptr);
 
-    R_ForEachContext([w, h](rendercontext_t &context) {
+    // Any overflow buffers went away along with the old context heaps
+    R_ForEachContext([](rendercontext_t &context) {
+        planecontext_t &plane = context.planecontext;
+
+        plane.openings.next = nullptr;
+        plane.skews.next    = nullptr;
+
+        // Portal contexts have buffers of their own, sized by R_FitPortalOpenings
+        // for each window they're given
+        if(context.portaltask)
+        {
+            plane.openings.buffer    = plane.skews.buffer    = nullptr;
+            plane.openings.bufferEnd = plane.skews.bufferEnd = nullptr;
+        }
+    });
+
+    R_UpdateContextOpenings(h);
+}
+
+//
+// Partitions the openings and skews buffers between the contexts according
+// to their current bounds. Needs calling whenever the bounds are changed.
+// Overflow buffers are kept for reuse.
+//
+void R_UpdateContextOpenings(const int h)
+{
+    if(!g_openings)
+        return;
+
+    R_ForEachContext([h](rendercontext_t &context) {
         planecontext_t        &plane  = context.planecontext;
         const contextbounds_t &bounds = context.bounds;
 
+        if(context.portaltask)
+            return;
+
         plane.openings.buffer    = g_openings + bounds.startcolumn * h;
         plane.openings.bufferEnd = plane.openings.buffer + bounds.numcolumns * h;
-        plane.openings.next      = nullptr;
         plane.curOpenings        = &plane.openings;
         plane.lastopening        = plane.openings.buffer;
 
         plane.skews.buffer    = g_skews + bounds.startcolumn * h;
         plane.skews.bufferEnd = plane.skews.buffer + bounds.numcolumns * h;
-        plane.skews.next      = nullptr;
         plane.curSkews        = &plane.skews;
         plane.lastskew        = plane.skews.buffer;
     });
 }
 
+//
+// Makes sure a portal context's openings and skews hold every column of the
+// window it's about to render. They only ever grow to the largest window seen,
+// rather than being sized for the whole view in every portal context.
+//
+void R_FitPortalOpenings(planecontext_t &context, ZoneHeap &heap, const contextbounds_t &bounds, const int h)
+{
+    const size_t length = size_t(bounds.numcolumns) * h;
+
+    if(size_t(context.openings.bufferEnd - context.openings.buffer) >= length)
+        return;
+
+    if(context.openings.buffer)
+    {
+        heap.free(context.openings.buffer);
+        heap.free(context.skews.buffer);
+    }
+
+    context.openings.buffer    = heap.malloc<float>(length * sizeof(float), PU_VALLOC, nullptr);
+    context.openings.bufferEnd = context.openings.buffer + length;
+    context.skews.buffer       = heap.malloc<float>(length * sizeof(float), PU_VALLOC, nullptr);
+    context.skews.bufferEnd    = context.skews.buffer + length;
+}
+
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
@@ -504,9 +583,70 @@ planehash_t *R_NewPlaneHash(ZoneHeap &heap, int chaincount)
     for(i = 0; i < chaincount; i++)
         ret->chains[i] = nullptr;
 
+    R_initPlaneHashIndex(heap, *ret, PU_LEVEL);
+
     return ret;
 }
 
+//
+// Allocates the lookup index for a plane hash
+//
+static void R_initPlaneHashIndex(ZoneHeap &heap, planehash_t &table, int tag)
+{
+    table.slotcount = 1;
+    while(table.slotcount < table.chaincount * PLANESLOTSPERCHAIN)
+        table.slotcount <<= 1;
+
+    table.slotsused  = 0;
+    table.generation = 1;
+    table.slots      = heap.calloc<planeslot_t>(table.slotcount, sizeof(planeslot_t), tag, nullptr);
+}
+
+//
+// Empties the lookup index of a plane hash
+//
+static void R_clearPlaneHashIndex(planehash_t &table)
+{
+    table.slotsused = 0;
+
+    // On wrapping around, old entries could come back to life
+    if(!++table.generation)
+    {
+        memset(table.slots, 0, table.slotcount * sizeof(*table.slots));
+        table.generation = 1;
+    }
+}
+
+//
+// The index only speeds up lookups while it's no more than half full. After
+// that, planes go only into the chains until the table is cleared.
+//
+inline static bool R_planeHashIndexed(const planehash_t &table)
+{
+    return table.slotsused < table.slotcount / 2;
+}
+
+//
+// Points the index entry for a plane at its duplicate instead, so lookups find
+// the newest plane first, as they would walking the chain
+//
+static void R_replaceIndexedPlane(planehash_t &table, const visplane_t *oldpl, visplane_t *newpl)
+{
+    if(!R_planeHashIndexed(table))
+        return;
+
+    const unsigned int mask = table.slotcount - 1;
+    for(unsigned int slot = oldpl->hashkey & mask; table.slots[slot].generation == table.generation;
+        slot              = (slot + 1) & mask)
+    {
+        if(table.slots[slot].plane == oldpl)
+        {
+            table.slots[slot].plane = newpl;
+            return;
+        }
+    }
+}
+
 //
 // Empties the chains of the given hash table and places the planes within
 // in the free stack.
@@ -518,6 +658,18 @@ void R_ClearPlaneHash(visplane_t **&freehead, planehash_t *table)
         for(*freehead = table->chains[i], table->chains[i] = nullptr; *freehead;)
             freehead = &(*freehead)->next;
     }
+    R_clearPlaneHashIndex(*table);
+}
+
+//
+// Empties the chains of the given hash table without keeping the planes, for
+// when they've been freed
+//
+void R_ClearPlaneHashChains(planehash_t *table)
+{
+    for(int i = 0; i < table->chaincount; i++)
+        table->chains[i] = nullptr;
+    R_clearPlaneHashIndex(*table);
 }
 
 //
@@ -638,24 +790,64 @@ visplane_t *R_FindPlane(cmapcontext_t &cmapcontext, planecontext_t &planecontext
             height = 1;
     }
 
+    const auto matches = [&](const visplane_t *check) {
+        return height == check->height && picnum == check->picnum && lightlevel == check->lightlevel &&
+               offs == check->offs &&                            // killough 2/28/98: Add offset checks
+               scale == check->scale && angle == check->angle && // haleyjd 01/05/08: Add angle
+               cmapcontext.zlight == check->colormap && cmapcontext.fixedcolormap == check->fixedcolormap &&
+               viewpoint.x == check->viewx && viewpoint.y == check->viewy && viewpoint.z == check->viewz &&
+               blendflags == check->bflags && opacity == check->opacity && R_CompareSlopes(check->pslope, slope);
+    };
+
     // New visplane algorithm uses hash table -- killough
     hash = visplane_hash(picnum, lightlevel, height >> 16, table->chaincount);
 
-    for(check = table->chains[hash]; check; check = check->next) // killough
+    // Everything compared above bar the slope, which is compared by value
+    unsigned int hashkey = R_mixPlaneHash(unsigned(height), unsigned(picnum));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(lightlevel));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(offs.x));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(offs.y));
+    hashkey              = R_mixPlaneHash(hashkey, scale.x);
+    hashkey              = R_mixPlaneHash(hashkey, scale.y);
+    hashkey              = R_mixPlaneHash(hashkey, angle);
+    hashkey              = R_mixPlaneHash(hashkey, cmapcontext.zlight);
+    hashkey              = R_mixPlaneHash(hashkey, cmapcontext.fixedcolormap);
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(viewpoint.x));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(viewpoint.y));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(viewpoint.z));
+    hashkey              = R_mixPlaneHash(hashkey, unsigned(blendflags << 8 | opacity));
+
+    const bool   indexed = R_planeHashIndexed(*table);
+    unsigned int slot    = 0;
+
+    if(indexed)
     {
-        // FIXME: ok this has gotten out of hand now!
-        // We need a more intelligent hash function or something.
-        if(height == check->height && picnum == check->picnum && lightlevel == check->lightlevel &&
-           offs == check->offs &&                            // killough 2/28/98: Add offset checks
-           scale == check->scale && angle == check->angle && // haleyjd 01/05/08: Add angle
-           cmapcontext.zlight == check->colormap && cmapcontext.fixedcolormap == check->fixedcolormap &&
-           viewpoint.x == check->viewx && viewpoint.y == check->viewy && viewpoint.z == check->viewz &&
-           blendflags == check->bflags && opacity == check->opacity && R_CompareSlopes(check->pslope, slope))
-            return check;
+        const unsigned int mask = table->slotcount - 1;
+        for(slot = hashkey & mask; table->slots[slot].generation == table->generation; slot = (slot + 1) & mask)
+        {
+            const planeslot_t &entry = table->slots[slot];
+            if(entry.hashkey == hashkey && matches(entry.plane))
+                return entry.plane;
+        }
+    }
+    else
+    {
+        for(check = table->chains[hash]; check; check = check->next) // killough
+        {
+            if(matches(check))
+                return check;
+        }
     }
 
     check = new_visplane(planecontext, heap, hash, table); // killough
 
+    check->hashkey = hashkey;
+    if(indexed)
+    {
+        table->slots[slot] = { check, hashkey, table->generation };
+        table->slotsused++;
+    }
+
     check->height        = height;
     check->picnum        = picnum;
     check->lightlevel    = lightlevel;
@@ -725,6 +917,9 @@ visplane_t *R_DupPlane(planecontext_t &context, ZoneHeap &heap, const visplane_t
     planehash_t *table  = pl->table;
     visplane_t  *new_pl = new_visplane(context, heap, pl->chainnum, table);
 
+    new_pl->hashkey = pl->hashkey;
+    R_replaceIndexedPlane(*table, pl, new_pl);
+
     new_pl->height        = pl->height;
     new_pl->picnum        = pl->picnum;
     new_pl->lightlevel    = pl->lightlevel;
@@ -1086,7 +1281,7 @@ static void do_draw_plane(cmapcontext_t &context, ZoneHeap &heap, int *const spa
         // Hexen animations can control only their own sequence swirling.
         if((r_swirl && textures[picnum]->flags & TF_ANIMATED) || textures[pl->picnum]->flags & TF_SWIRLY)
         {
-            plane.source = R_DistortedFlat(heap, picnum);
+            plane.source = R_DistortedFlat(picnum);
             tex = plane.tex = textures[picnum];
         }
         else
@@ -1244,7 +1439,7 @@ VALLOCATION(overlaySets)
 {
     R_ForEachContext([](rendercontext_t &basecontext) {
         for(planehash_t *set = basecontext.planecontext.r_overlayfreesets; set; set = set->next)
-            memset(set->chains, 0, set->chaincount * sizeof(*set->chains));
+            R_ClearPlaneHashChains(set);
     });
 }
 
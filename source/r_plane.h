@@ -48,12 +48,15 @@ extern float *overlayfclip, *overlaycclip;
 
 void R_ClearPlanes(planecontext_t &context, const contextbounds_t &bounds);
 void R_ClearOverlayClips(const contextbounds_t &bounds);
+void R_UpdateContextOpenings(const int h);
+void R_FitPortalOpenings(planecontext_t &context, ZoneHeap &heap, const contextbounds_t &bounds, const int h);
 void R_DrawPlanes(cmapcontext_t &context, ZoneHeap &heap, planehash_t &mainhash, int *const spanstart,
                   planehash_t *table);
 
 // Planehash stuff
 planehash_t *R_NewPlaneHash(ZoneHeap &heap, int chaincount);
 void         R_ClearPlaneHash(visplane_t **&freehead, planehash_t *table);
+void         R_ClearPlaneHashChains(planehash_t *table);
 
 visplane_t *R_FindPlane(cmapcontext_t &cmapcontext, planecontext_t &planecontext, ZoneHeap &heap,
                         const viewpoint_t &viewpoint, const cbviewpoint_t &cb_viewpoint, const contextbounds_t &bounds,
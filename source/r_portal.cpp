@@ -24,6 +24,8 @@
 // Authors: Stephen McGranahan, James Haley, Ioan Chera, Max Waine
 //
 
+#include <algorithm>
+
 #include "z_zone.h"
 #include "i_system.h"
 
@@ -33,6 +35,7 @@
 #include "e_things.h"
 #include "m_bbox.h"
 #include "m_collection.h"
+#include "m_compare.h"
 #include "p_setup.h"
 #include "p_spec.h"
 #include "r_bsp.h"
@@ -111,8 +114,7 @@ VALLOCATION(portals)
             {
                 next = child->child;
                 if((hash = child->poverlay))
-                    for(int i = 0; i < hash->chaincount; ++i)
-                        hash->chains[i] = nullptr;
+                    R_ClearPlaneHashChains(hash);
                 heap.free(child->top);
                 heap.free(child);
                 child = next;
@@ -121,8 +123,7 @@ VALLOCATION(portals)
             // free this window
             next = rover->next;
             if((hash = rover->poverlay))
-                for(int i = 0; i < hash->chaincount; ++i)
-                    hash->chains[i] = nullptr;
+                R_ClearPlaneHashChains(hash);
             heap.free(rover->top);
             heap.free(rover);
             rover = next;
@@ -134,8 +135,7 @@ VALLOCATION(portals)
         {
             pwindow_t *next = rover->next;
             if((hash = rover->poverlay))
-                for(int i = 0; i < hash->chaincount; ++i)
-                    hash->chains[i] = nullptr;
+                R_ClearPlaneHashChains(hash);
             heap.free(rover->top);
             heap.free(rover);
             rover = next;
@@ -1298,6 +1298,162 @@ void R_MovePortalOverlayToWindow(cmapcontext_t &cmapcontext, planecontext_t &pla
     //      R_ClearPlaneHash(portal->poverlay);
 }
 
+// Most windows looked at for handing out in one go
+static constexpr int MAXPORTALTASKS = 64;
+
+//
+// Takes a window out of the context's list and puts it and its children on the
+// unused list, as the portal loop does once it has rendered a window
+//
+static void R_releasePortalWindow(portalcontext_t &portalcontext, pwindow_t *window)
+{
+    pwindow_t *&unusedhead = portalcontext.unusedhead;
+
+    pwindow_t *prev = nullptr;
+    for(pwindow_t **link = &portalcontext.windowhead; *link; prev = *link, link = &(*link)->next)
+    {
+        if(*link == window)
+        {
+            *link = window->next;
+            if(portalcontext.windowlast == window)
+                portalcontext.windowlast = prev;
+            break;
+        }
+    }
+
+    pwindow_t *w = window->child;
+    while(w)
+    {
+        pwindow_t *next = w->child;
+        w->next         = unusedhead;
+        w->child        = nullptr;
+        unusedhead      = w;
+        w               = next;
+    }
+
+    window->next  = unusedhead;
+    window->child = nullptr;
+    unusedhead    = window;
+}
+
+//
+// Hands the skybox, anchored and linked windows of the context which don't share
+// any columns out to the portal contexts. Their overlays are kept here and pushed
+// on the post-BSP stack, so they still get drawn over the portal and under the
+// context's own masked content. Returns true if any windows were handed out.
+//
+static bool R_dispatchPortalWindows(rendercontext_t &context)
+{
+    portaltask_t tasks[MAXPORTALTASKS];
+    int          numtasks = 0;
+
+    for(pwindow_t *window = context.portalcontext.windowhead; window && numtasks < MAXPORTALTASKS;
+        window            = window->next)
+    {
+        if(window->func != R_renderWorldPortal || window->maxx < window->minx)
+            continue;
+
+        portaltask_t &task = tasks[numtasks++];
+        task.window        = window;
+        task.overlay       = nullptr;
+        task.minx          = window->minx;
+        task.maxx          = window->maxx;
+        for(const pwindow_t *child = window->child; child; child = child->child)
+        {
+            if(child->maxx >= child->minx)
+            {
+                task.minx = emin(task.minx, child->minx);
+                task.maxx = emax(task.maxx, child->maxx);
+            }
+        }
+    }
+
+    // Keep as many windows as possible that don't overlap, by taking the one that
+    // ends leftmost each time
+    std::sort(tasks, tasks + numtasks,
+              [](const portaltask_t &a, const portaltask_t &b) { return a.maxx < b.maxx; });
+
+    int numkept = 0;
+    for(int i = 0, lastx = -1; i < numtasks; i++)
+    {
+        if(tasks[i].minx > lastx)
+        {
+            lastx            = tasks[i].maxx;
+            tasks[numkept++] = tasks[i];
+        }
+    }
+    numtasks = numkept;
+
+    if(numtasks < 2)
+        return false;
+
+    for(int i = 0; i < numtasks; i++)
+    {
+        tasks[i].overlay          = tasks[i].window->poverlay;
+        tasks[i].window->poverlay = nullptr;
+    }
+
+    if(!R_RunPortalTasks(context, tasks, numtasks))
+    {
+        for(int i = 0; i < numtasks; i++)
+            tasks[i].window->poverlay = tasks[i].overlay;
+        return false;
+    }
+
+    for(int i = 0; i < numtasks; i++)
+    {
+        pwindow_t *window = tasks[i].window;
+
+        window->poverlay = tasks[i].overlay;
+        if(window->poverlay)
+        {
+            R_PushPost(context.view, context.cb_view, context.bspcontext, context.spritecontext, *context.heap,
+                       context.bounds, false, window);
+        }
+
+        R_releasePortalWindow(context.portalcontext, window);
+    }
+
+    return true;
+}
+
+//
+// Renders a window handed out by R_dispatchPortalWindows, along with any portals
+// seen through it, in a portal context bounded to the window's columns
+//
+void R_RenderPortalTask(rendercontext_t &context, const rendercontext_t &parent, const portaltask_t &task)
+{
+    portalrender_t &portalrender = context.portalcontext.portalrender;
+    pwindow_t      *window       = task.window;
+
+    context.view        = parent.view;
+    context.cb_view     = parent.cb_view;
+    context.cmapcontext = parent.cmapcontext;
+
+    R_ClearDrawSegs(context.bspcontext);
+    R_ClearPlanes(context.planecontext, context.bounds);
+    R_ClearSprites(context.spritecontext);
+
+    portalrender.active      = true;
+    portalrender.w           = window;
+    portalrender.segClipFunc = window->clipfunc;
+
+    window->func(context, window);
+
+    portalrender.active      = false;
+    portalrender.w           = nullptr;
+    portalrender.segClipFunc = nullptr;
+
+    R_RenderPortals(context);
+
+    R_DrawPlanes(context.cmapcontext, *context.heap, context.planecontext.mainhash, context.planecontext.spanstart,
+                 nullptr);
+    R_DrawPostBSP(context);
+
+    if(r_column_engine->ResetBuffer)
+        r_column_engine->ResetBuffer();
+}
+
 //
 // Primary portal rendering function.
 //
@@ -1310,6 +1466,12 @@ void R_RenderPortals(rendercontext_t &context)
 
     pwindow_t *w;
 
+    if(r_numportalcontexts && !context.portaltask)
+    {
+        while(R_dispatchPortalWindows(context))
+            ;
+    }
+
     while(windowhead)
     {
         portalrender.active      = true;
@@ -223,6 +223,16 @@ void R_MovePortalOverlayToWindow(cmapcontext_t &cmapcontext, planecontext_t &pla
                                  const contextbounds_t &bounds, cb_seg_t &seg, surf_e surf);
 void R_RenderPortals(rendercontext_t &context);
 
+// A portal window handed over to a portal context to render
+struct portaltask_t
+{
+    pwindow_t   *window;
+    planehash_t *overlay;    // stays with the context which found the window
+    int          minx, maxx; // columns covered by the window and its children
+};
+
+void R_RenderPortalTask(rendercontext_t &context, const rendercontext_t &parent, const portaltask_t &task);
+
 portal_t *R_GetLinkedPortal(int markerlinenum, int anchorlinenum, fixed_t planez, int fromid, int toid);
 
 void R_CalcRenderBarrier(pwindow_t &window, const sectorbox_t &box);
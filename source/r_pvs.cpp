@@ -0,0 +1,155 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Potentially visible sets of sectors, used to cull the BSP.
+//
+//  The sets themselves are worked out in the background when the level
+//  loads, in p_secvis.cpp. Nothing is culled until they're ready; from then
+//  on, the BSP traversal for the main view skips any node which holds
+//  nothing visible from the view's sector.
+//
+//  The sets are per sector rather than per subsector. Classic nodes have no
+//  minisegs, so which subsectors border each other isn't known, but which
+//  sectors do is.
+//
+
+#include "z_zone.h"
+#include "c_runcmd.h"
+#include "doomstat.h"
+#include "m_compare.h"
+#include "p_secvis.h"
+#include "r_context.h"
+#include "r_pvs.h"
+#include "r_state.h"
+
+bool r_pvs = false;
+
+static byte       *g_pvsnodes;       // nodes holding something visible
+static const byte *g_pvsrow;         // sectors visible from g_pvssector
+static int         g_pvssector = -1; // sector g_pvsnodes was worked out for
+static bool        g_pvsactive;      // culling the main view this frame
+
+inline static bool R_pvsTest(const byte *row, int secnum)
+{
+    return row[secnum >> 3] & (1 << (secnum & 7));
+}
+
+//
+// Gets the visible sets for the level just loaded on their way, if culling
+// is enabled. Doesn't wait for them.
+//
+void R_BuildPVS()
+{
+    R_ClearPVS();
+
+    if(!r_pvs || !numsectors)
+        return;
+
+    if(!g_pvsnodes)
+    {
+        g_pvsnodes =
+            ecalloctag(byte *, emax(numnodes, 1), sizeof(byte), PU_LEVEL, reinterpret_cast<void **>(&g_pvsnodes));
+    }
+
+    P_BuildSecVis();
+}
+
+//
+// Forgets the sector the nodes were marked for
+//
+void R_ClearPVS()
+{
+    g_pvsrow    = nullptr;
+    g_pvssector = -1;
+    g_pvsactive = false;
+}
+
+//
+// Marks the nodes with anything visible in them
+//
+static bool R_pvsMarkNodes(int bspnum)
+{
+    if(bspnum & NF_SUBSECTOR)
+        return R_PVSChildVisible(bspnum);
+
+    const node_t &node    = nodes[bspnum];
+    const bool    visible = R_pvsMarkNodes(node.children[0]) | R_pvsMarkNodes(node.children[1]);
+
+    g_pvsnodes[bspnum] = visible;
+    return visible;
+}
+
+//
+// Sets up culling for the main view for this frame. Looking from outside the
+// map (when noclipping, for instance) can see anything, so that isn't culled.
+//
+void R_SetupPVS(const viewpoint_t &viewpoint)
+{
+    g_pvsactive = false;
+
+    if(!r_pvs || !g_pvsnodes || !numnodes || !viewpoint.sector)
+        return;
+
+    const int   secnum = int(viewpoint.sector - sectors);
+    const byte *row    = P_SecVisRow(secnum);
+    if(!row || !P_SecVisPointInSector(*viewpoint.sector, viewpoint.x, viewpoint.y))
+        return;
+
+    if(secnum != g_pvssector || row != g_pvsrow)
+    {
+        g_pvsrow    = row;
+        g_pvssector = secnum;
+        R_pvsMarkNodes(numnodes - 1);
+    }
+
+    g_pvsactive = true;
+}
+
+bool R_PVSActive()
+{
+    return g_pvsactive;
+}
+
+//
+// Checks if a BSP child holds anything visible from the view's sector
+//
+bool R_PVSChildVisible(int bspnum)
+{
+    if(bspnum & NF_SUBSECTOR)
+    {
+        const int ssnum = bspnum == -1 ? 0 : bspnum & ~NF_SUBSECTOR;
+        return R_pvsTest(g_pvsrow, int(subsectors[ssnum].sector - sectors));
+    }
+
+    return g_pvsnodes[bspnum];
+}
+
+VARIABLE_TOGGLE(r_pvs, nullptr, onoff);
+CONSOLE_VARIABLE(r_pvs, r_pvs, 0)
+{
+    if(!r_pvs)
+        R_ClearPVS();
+    else if(gamestate == GS_LEVEL)
+        R_BuildPVS();
+}
+
+// EOF
@@ -24,6 +24,10 @@
 // Authors: Simon Howard, James Haley, Stephen McGranahan, Ioan Chera, Max Waine
 //
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "z_zone.h"
 #include "doomdef.h"
 #include "doomstat.h"
@@ -32,10 +36,9 @@
 #include "r_defs.h"
 #include "r_data.h"
 #include "r_draw.h"
+#include "r_ripple.h"
 #include "w_wad.h"
-#include "v_alloc.h"
 #include "v_video.h"
-#include "z_zone.h"
 
 // swirl factors determine the number of waves per flat width
 // 1 cycle per 64 units
@@ -45,56 +48,44 @@
 // 1 cycle per 32 units (2 in 64)
 #define SWIRLFACTOR2 (8192/32)
 
-static thread_local byte *normalflat;
-int                       r_swirl; // hack
-
-#if 0
-// DEBUG: draw lines on the flat to see the distortion
-static void R_DrawLines(void)
-{
-    int x, y;
-
-    for(x = 0; x < 64; ++x)
-    {
-        for(y = 0; y < 64; ++y)
-        {
-            if((!x % 8) || (!y % 8))
-                normalflat[(y << 6) + x] = 0;
-        }
-    }
-}
-#endif
+int r_swirl; // hack
 
 #define AMP 2
 #define AMP2 2
 #define SPEED 40
 
-static thread_local int   lasttex  = -1;
-static thread_local int   swirltic = -1;
-static thread_local int  *offset;
-static thread_local int   offsetSize;
-static thread_local byte *distortedflat;
-static thread_local int   lastsize;
+//
+// A distorted flat, shared by every render context. Whichever context asks for
+// it first in a tic builds it; contexts after different flats build theirs at
+// the same time.
+//
+struct swirlflat_t
+{
+    std::atomic<int>        swirltic = -1; // tic the flat was last built for
+    std::mutex              mutex;         // held while building
+    std::unique_ptr<byte[]> data;          // pixels, followed by the mask if any
+};
 
-VALLOCATION(distortedflat)
+// One set for leveltime and one for gametic, which the menu backgrounds use,
+// so the two never rebuild each other's flats
+static std::unique_ptr<swirlflat_t[]> swirlflats[2];
+
+//
+// Sizes the cache for the current texture count. Must be called whenever
+// textures are (re)loaded, while nothing is rendering.
+//
+void R_InitSwirlCache()
 {
-    lasttex       = -1;
-    swirltic      = -1;
-    offset        = nullptr;
-    offsetSize    = 0;
-    distortedflat = nullptr;
-    lastsize      = 0;
+    for(std::unique_ptr<swirlflat_t[]> &flats : swirlflats)
+        flats = std::make_unique<swirlflat_t[]>(texturecount);
 }
 
 //
 // Generates a distorted flat from a normal one using a two-dimensional
 // sine wave pattern.
 //
-byte *R_DistortedFlat(ZoneHeap &heap, int texnum, bool usegametic)
+static void R_swirlFlat(swirlflat_t &flat, int texnum, int leveltic)
 {
-    int              i;
-    int              reftime  = usegametic ? gametic : leveltime;
-    int              leveltic = reftime;
     const texture_t *tex      = R_GetTexture(texnum);
     const byte      *flatmask =
         tex->flags & TF_MASKED ? tex->bufferdata + tex->width * tex->height : nullptr; // also change the trailing mask
@@ -104,71 +95,66 @@ byte *R_DistortedFlat(ZoneHeap &heap, int texnum, bool usegametic)
     int16_t w       = tex->height;
     int     cursize = w * h;
 
-    if(cursize * 2 > offsetSize)
-    {
-        offsetSize    = cursize * 4;
-        offset        = heap.realloc<int>(offset, offsetSize * sizeof(*offset));
-        distortedflat = heap.realloc<byte>(distortedflat, offsetSize * sizeof(*distortedflat));
-    }
-    // Already swirled this one?
-    if(reftime == swirltic && lasttex == texnum)
-        return distortedflat;
+    if(!flat.data)
+        flat.data = std::make_unique<byte[]>(cursize + (cursize + 7) / 8);
 
-    lasttex = texnum;
+    const byte *normalflat    = tex->bufferdata;
+    byte       *distortedflat = flat.data.get();
+    byte       *distortedmask = distortedflat + cursize;
 
-    // built this tic?
-    if(reftime != swirltic || cursize != lastsize)
+    for(int x = 0; x < w; ++x)
     {
-        int x, y;
-
-        if(offset) // just to silence the static analyzer
+        for(int y = 0; y < h; ++y)
         {
-            for(x = 0; x < w; ++x)
+            int x1, y1;
+            int sinvalue, sinvalue2;
+
+            sinvalue  = (y * SWIRLFACTOR + leveltic * SPEED * 5 + 900) & 8191;
+            sinvalue2 = (x * SWIRLFACTOR2 + leveltic * SPEED * 4 + 300) & 8191;
+            x1        = x + 128 + ((finesine[sinvalue] * AMP) >> FRACBITS) + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
+
+            sinvalue  = (x * SWIRLFACTOR + leveltic * SPEED * 3 + 700) & 8191;
+            sinvalue2 = (y * SWIRLFACTOR2 + leveltic * SPEED * 4 + 1200) & 8191;
+            y1        = y + 128 + ((finesine[sinvalue] * AMP) >> FRACBITS) + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
+
+            x1 %= w;
+            y1 %= h;
+
+            const int i      = (y * w) + x;
+            const int offset = (y1 * w) + x1;
+
+            distortedflat[i] = normalflat[offset];
+            if(flatmask)
             {
-                for(y = 0; y < h; ++y)
-                {
-                    int x1, y1;
-                    int sinvalue, sinvalue2;
-
-                    sinvalue  = (y * SWIRLFACTOR + leveltic * SPEED * 5 + 900) & 8191;
-                    sinvalue2 = (x * SWIRLFACTOR2 + leveltic * SPEED * 4 + 300) & 8191;
-                    x1 =
-                        x + 128 + ((finesine[sinvalue] * AMP) >> FRACBITS) + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
-
-                    sinvalue  = (x * SWIRLFACTOR + leveltic * SPEED * 3 + 700) & 8191;
-                    sinvalue2 = (y * SWIRLFACTOR2 + leveltic * SPEED * 4 + 1200) & 8191;
-                    y1 =
-                        y + 128 + ((finesine[sinvalue] * AMP) >> FRACBITS) + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
-
-                    x1 %= w;
-                    y1 %= h;
-
-                    offset[(y * w) + x] = (y1 * w) + x1;
-                }
+                byte v = !!(flatmask[offset >> 3] & 1 << (offset & 7));
+
+                // https://stackoverflow.com/a/47990
+                distortedmask[i >> 3] ^= (-v ^ distortedmask[i >> 3]) & 1 << (i & 7);
             }
         }
-
-        swirltic = reftime;
-        lastsize = cursize;
     }
+}
 
-    normalflat = tex->bufferdata;
+//
+// Returns the distorted flat for this tic, building it if nobody has yet.
+//
+byte *R_DistortedFlat(int texnum, bool usegametic)
+{
+    const int    reftime = usegametic ? gametic : leveltime;
+    swirlflat_t &flat    = swirlflats[usegametic][texnum];
 
-    byte *distortedmask = distortedflat + cursize;
-    for(i = 0; i < cursize; ++i)
-    {
-        distortedflat[i] = normalflat[offset[i]];
-        if(flatmask)
-        {
-            byte v = !!(flatmask[offset[i] >> 3] & 1 << (offset[i] & 7));
+    // Already swirled this one?
+    if(flat.swirltic.load(std::memory_order_acquire) == reftime)
+        return flat.data.get();
 
-            // https://stackoverflow.com/a/47990
-            distortedmask[i >> 3] ^= (-v ^ distortedmask[i >> 3]) & 1 << (i & 7);
-        }
+    std::lock_guard lock(flat.mutex);
+    if(flat.swirltic.load(std::memory_order_relaxed) != reftime)
+    {
+        R_swirlFlat(flat, texnum, reftime);
+        flat.swirltic.store(reftime, std::memory_order_release);
     }
 
-    return distortedflat;
+    return flat.data.get();
 }
 
 // EOF
-
@@ -26,14 +26,13 @@
 
 #include "doomtype.h"
 
-class ZoneHeap;
-
 enum
 {
     SWIRL_TICS = 65536 // the amount to set in definition lumps
 };
 
-byte *R_DistortedFlat(ZoneHeap &heap, int flatnum, bool usegametic = false);
+void  R_InitSwirlCache();
+byte *R_DistortedFlat(int flatnum, bool usegametic = false);
 
 extern int r_swirl;
 
@@ -885,8 +885,14 @@ while(count--)
 }
 #endif
 
-#define SPANJUMP 16
-#define INTERPSTEP (0.0625f)
+//
+// Sloped planes are only divided exactly every few pixels, and interpolated
+// linearly in between. r_slopesubdiv picks how many.
+//
+inline static int R_slopeSpanJump()
+{
+    return 8 << r_slopesubdiv;
+}
 
 #define DO_SLOPE_SAMPLE() \
     do                                                                                \
@@ -945,7 +951,10 @@ inline static void R_drawSlope_8(const cb_slopespan_t &slopespan, const cb_span_
 
     const byte *alpham = static_cast<const byte *>(span.alphamask);
 
-    while(count >= SPANJUMP)
+    const int    spanjump   = R_slopeSpanJump();
+    const double interpstep = 1.0 / spanjump;
+
+    while(count >= spanjump)
     {
         double       ustart, uend;
         double       vstart, vend;
@@ -954,28 +963,28 @@ inline static void R_drawSlope_8(const cb_slopespan_t &slopespan, const cb_span_
         int          incount;
 
         mulstart  = 65536.0f / id;
-        id       += ids * SPANJUMP;
+        id       += ids * spanjump;
         mulend    = 65536.0f / id;
 
         // IMPORTANT: use this function to properly handle negative numbers. Merely casting is
         // non-standard between CPUs and will glitch out.
         ufrac  = R_doubleToUint32(ustart = iu * mulstart);
         vfrac  = R_doubleToUint32(vstart = iv * mulstart);
-        iu    += ius * SPANJUMP;
-        iv    += ivs * SPANJUMP;
+        iu    += ius * spanjump;
+        iv    += ivs * spanjump;
         uend   = iu * mulend;
         vend   = iv * mulend;
 
-        ustep = R_doubleToUint32((uend - ustart) * INTERPSTEP);
-        vstep = R_doubleToUint32((vend - vstart) * INTERPSTEP);
+        ustep = R_doubleToUint32((uend - ustart) * interpstep);
+        vstep = R_doubleToUint32((vend - vstart) * interpstep);
 
-        incount = SPANJUMP;
+        incount = spanjump;
         while(incount--)
         {
             DO_SLOPE_SAMPLE();
         }
 
-        count -= SPANJUMP;
+        count -= spanjump;
     }
     if(count > 0)
     {
@@ -1026,11 +1035,14 @@ inline static void R_drawSlope_8_GEN(const cb_slopespan_t &slopespan, const cb_s
 
     const byte *alpham = static_cast<const byte *>(span.alphamask);
 
+    const int    spanjump   = R_slopeSpanJump();
+    const double interpstep = 1.0 / spanjump;
+
     unsigned int xshift = span.xshift;
     unsigned int xmask  = span.xmask;
     unsigned int ymask  = span.ymask;
 
-    while(count >= SPANJUMP)
+    while(count >= spanjump)
     {
         double       ustart, uend;
         double       vstart, vend;
@@ -1039,26 +1051,26 @@ inline static void R_drawSlope_8_GEN(const cb_slopespan_t &slopespan, const cb_s
         int          incount;
 
         mulstart  = 65536.0f / id;
-        id       += ids * SPANJUMP;
+        id       += ids * spanjump;
         mulend    = 65536.0f / id;
 
         ufrac  = R_doubleToUint32(ustart = iu * mulstart);
         vfrac  = R_doubleToUint32(vstart = iv * mulstart);
-        iu    += ius * SPANJUMP;
-        iv    += ivs * SPANJUMP;
+        iu    += ius * spanjump;
+        iv    += ivs * spanjump;
         uend   = iu * mulend;
         vend   = iv * mulend;
 
-        ustep = R_doubleToUint32((uend - ustart) * INTERPSTEP);
-        vstep = R_doubleToUint32((vend - vstart) * INTERPSTEP);
+        ustep = R_doubleToUint32((uend - ustart) * interpstep);
+        vstep = R_doubleToUint32((vend - vstart) * interpstep);
 
-        incount = SPANJUMP;
+        incount = spanjump;
         while(incount--)
         {
             DO_SLOPE_SAMPLE();
         }
 
-        count -= SPANJUMP;
+        count -= spanjump;
     }
     if(count > 0)
     {
@@ -1109,10 +1121,13 @@ inline static void R_drawSlope_8_NPOT(const cb_slopespan_t &slopespan, const cb_
 
     const byte *alpham = static_cast<const byte *>(span.alphamask);
 
+    const int    spanjump   = R_slopeSpanJump();
+    const double interpstep = 1.0 / spanjump;
+
     int width  = (int)span.xmask;
     int height = (int)span.ymask;
 
-    while(count >= SPANJUMP)
+    while(count >= spanjump)
     {
         double       ustart, uend;
         double       vstart, vend;
@@ -1121,26 +1136,26 @@ inline static void R_drawSlope_8_NPOT(const cb_slopespan_t &slopespan, const cb_
         int          incount;
 
         mulstart  = 65536.0f / id;
-        id       += ids * SPANJUMP;
+        id       += ids * spanjump;
         mulend    = 65536.0f / id;
 
         ufrac  = R_doubleToUint32(ustart = iu * mulstart);
         vfrac  = R_doubleToUint32(vstart = iv * mulstart);
-        iu    += ius * SPANJUMP;
-        iv    += ivs * SPANJUMP;
+        iu    += ius * spanjump;
+        iv    += ivs * spanjump;
         uend   = iu * mulend;
         vend   = iv * mulend;
 
-        ustep = R_doubleToUint32((uend - ustart) * INTERPSTEP);
-        vstep = R_doubleToUint32((vend - vstart) * INTERPSTEP);
+        ustep = R_doubleToUint32((uend - ustart) * interpstep);
+        vstep = R_doubleToUint32((vend - vstart) * interpstep);
 
-        incount = SPANJUMP;
+        incount = spanjump;
         while(incount--)
         {
             DO_SLOPE_SAMPLE_NPOT();
         }
 
-        count -= SPANJUMP;
+        count -= spanjump;
     }
     if(count > 0)
     {
@@ -1281,9 +1296,6 @@ static void R_drawSlopeAddMasked_8_NPOT(const cb_slopespan_t &slopespan, const c
     R_drawSlope_8_NPOT<maskedSlope_e::YES, Sampler::Additive>(slopespan, span);
 }
 
-#undef SPANJUMP
-#undef INTERPSTEP
-
 //==============================================================================
 //
 // Span Engine Objects
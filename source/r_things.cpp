@@ -106,6 +106,7 @@ enum
 float *zeroarray;
 float *screenheightarray;
 int    lefthanded = 0;
+bool   r_radixsort = true;
 
 VALLOCATION(zeroarray)
 {
@@ -1892,6 +1893,89 @@ static void msort(vissprite_t **s, vissprite_t **t, int n)
     }
 }
 
+// Below this many sprites, msort's insertion sort is quicker
+static constexpr unsigned int RADIXSORT_MIN = 64;
+
+//
+// Maps a sprite's distance onto an unsigned integer which sorts in the same
+// order as the float, flipped so that farther sprites come first
+//
+inline static uint32_t R_spriteSortKey(const vissprite_t *vis)
+{
+    uint32_t bits;
+    memcpy(&bits, &vis->dist, sizeof(bits));
+    if(bits == 0x80000000) // -0 is equal to 0 for msort too
+        bits = 0;
+    bits = bits & 0x80000000 ? ~bits : bits | 0x80000000;
+    return ~bits;
+}
+
+//
+// Lays out pointers to n sprites in the order msort leaves sprites of equal
+// distance: its insertion sort keeps them as they were, and each merge puts
+// the second half's ahead of the first's. Radix sorting these gives exactly
+// what msort would.
+//
+static void R_msortTieOrder(vissprite_t **d, vissprite_t *s, int n)
+{
+    if(n >= 16)
+    {
+        const int n1 = n / 2, n2 = n - n1;
+
+        R_msortTieOrder(d, s + n1, n2);
+        R_msortTieOrder(d + n2, s, n1);
+    }
+    else
+    {
+        for(int i = 0; i < n; i++)
+            d[i] = s + i;
+    }
+}
+
+//
+// Stable LSD radix sort of sprites by distance, a byte at a time. t needs to
+// have room for n sprites, same as with msort. Sprites at the same distance
+// stay in the order they're given, so lay them out with R_msortTieOrder.
+//
+static void R_radixSortVisSprites(vissprite_t **s, vissprite_t **t, int n)
+{
+    unsigned int counts[4][256] = {};
+
+    for(int i = 0; i < n; i++)
+    {
+        const uint32_t key = R_spriteSortKey(s[i]);
+        for(int pass = 0; pass < 4; pass++)
+            counts[pass][(key >> (pass * 8)) & 0xff]++;
+    }
+
+    vissprite_t **src = s, **dst = t;
+    for(int pass = 0; pass < 4; pass++)
+    {
+        unsigned int *count = counts[pass];
+        const int     shift = pass * 8;
+
+        // Skip bytes which are the same for every sprite
+        if(count[(R_spriteSortKey(src[0]) >> shift) & 0xff] == static_cast<unsigned int>(n))
+            continue;
+
+        unsigned int offset = 0;
+        for(unsigned int &bucket : counts[pass])
+        {
+            const unsigned int size = bucket;
+            bucket                  = offset;
+            offset                 += size;
+        }
+
+        for(int i = 0; i < n; i++)
+            dst[count[(R_spriteSortKey(src[i]) >> shift) & 0xff]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    if(src != s)
+        bcopyp(s, src, n);
+}
+
 //
 // Sorts only a subset of the vissprites, for portal rendering.
 //
@@ -1906,8 +1990,6 @@ static void R_sortVisSpriteRange(spritecontext_t &context, ZoneHeap &heap, int f
 
     if(numsprites > 0)
     {
-        int i = numsprites;
-
         // If we need to allocate more pointers for the vissprites,
         // allocate as many as were allocated for sprites -- killough
         // killough 9/22/98: allocate twice as many
@@ -1919,13 +2001,22 @@ static void R_sortVisSpriteRange(spritecontext_t &context, ZoneHeap &heap, int f
             vissprite_ptrs     = heap.malloc<vissprite_t *>(num_vissprite_ptrs * sizeof *vissprite_ptrs);
         }
 
-        while(--i >= 0)
-            vissprite_ptrs[i] = vissprites + i + first;
-
         // killough 9/22/98: replace qsort with merge sort, since the keys
         // are roughly in order to begin with, due to BSP rendering.
 
-        msort(vissprite_ptrs, vissprite_ptrs + numsprites, numsprites);
+        if(r_radixsort && numsprites >= RADIXSORT_MIN)
+        {
+            R_msortTieOrder(vissprite_ptrs, vissprites + first, numsprites);
+            R_radixSortVisSprites(vissprite_ptrs, vissprite_ptrs + numsprites, numsprites);
+        }
+        else
+        {
+            int i = numsprites;
+            while(--i >= 0)
+                vissprite_ptrs[i] = vissprites + i + first;
+
+            msort(vissprite_ptrs, vissprite_ptrs + numsprites, numsprites);
+        }
     }
 }
 
@@ -2865,6 +2956,10 @@ static void R_drawParticle(const contextbounds_t &bounds, vissprite_t *vis, cons
     int  yl, yh;
     byte color;
 
+    // Sprite columns may still be held back by the column engine
+    if(r_column_engine->ResetBuffer)
+        r_column_engine->ResetBuffer();
+
     ox1 = x1 = vis->x1;
     ox2 = x2 = vis->x2;
 
@@ -49,6 +49,8 @@ using R_ColumnFunc = void (*)(cb_column_t &);
 extern float *zeroarray;
 extern float *screenheightarray;
 
+extern bool r_radixsort;
+
 // SoM 12/13/03: the stack for use with portals
 struct maskedrange_t
 {
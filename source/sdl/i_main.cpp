@@ -111,10 +111,12 @@ int main(int argc, char **argv)
     // haleyjd 04/15/02: added check for failure
     // ioanch: avoid loading SDL_VIDEO if -nodraw and -nosound are combined.
     // FIXME: code duplication; the global booleans aren't assigned yet.
+    // -headless never opens a window either, so it mustn't need a display.
     Uint32 initflags =
         (M_CheckParm("-nodraw") && (M_CheckParm("-nosound") || (M_CheckParm("-nosfx") && M_CheckParm("-nomusic")))) ?
             SDL_INIT_JOYSTICK :
-            SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER;
+        M_CheckParm("-headless") ? SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER :
+                                   SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER;
     if(SDL_Init(initflags) == -1)
     {
         printf("Failed to initialize SDL library: %s\n", SDL_GetError());
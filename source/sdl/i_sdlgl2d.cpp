@@ -23,12 +23,17 @@
 
 #ifdef EE_FEATURE_OPENGL
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 // SDL headers
 #include "SDL.h"
 #include "SDL_opengl.h"
 
 // HAL header
 #include "../hal/i_platform.h"
+#include "../hal/i_present.h"
 
 // DOOM headers
 #include "../z_zone.h"
@@ -94,6 +99,23 @@ static int bump;
 static bool   use_arb_pbo; // If true, use ARB pixel buffer object extension
 static GLuint pboIDs[2];   // IDs of pixel buffer objects
 
+// Frames waiting for the present thread; see SDLGL2DVideoDriver::FinishUpdate
+static constexpr int NUMPRESENTFRAMES = 3;
+
+struct presentframe_t
+{
+    byte  *pixels;
+    Uint32 palette[256];
+};
+
+static presentframe_t          presentframes[NUMPRESENTFRAMES];
+static int                     presenthead;  // frame being shown, or to be shown next
+static int                     queuedframes; // frames queued, including the head
+static bool                    presentquit;
+static std::mutex              presentmutex;
+static std::condition_variable presentcv;
+static std::thread             presentthread;
+
 // PBO extension function pointers
 static PFNGLGENBUFFERSARBPROC    pglGenBuffersARB    = nullptr;
 static PFNGLDELETEBUFFERSARBPROC pglDeleteBuffersARB = nullptr;
@@ -153,60 +175,31 @@ static void GL2D_setupVertexArray(const GLfloat x, const GLfloat y, const GLfloa
 //
 // Protected method.
 //
-void SDLGL2DVideoDriver::DrawPixels(void *buffer, unsigned int destheight)
+void SDLGL2DVideoDriver::DrawPixels(const byte *src, const uint32_t *palette, void *buffer, unsigned int destheight)
 {
     Uint32   *fb            = static_cast<Uint32 *>(buffer);
-    const int d_end         = screen->w & ~7;
-    const int d_remainder   = screen->w & 7;
     const int render_height = screen->h - bump;
 
+    // The texture keeps the frame's column-major layout (the texture coordinates
+    // do the transpose), so each column only needs expanding.
     for(int y = 0; y < render_height; y++)
-    {
-        byte   *src  = static_cast<byte *>(screen->pixels) + y * screen->pitch;
-        Uint32 *dest = fb + y * destheight;
-
-        for(int x = d_end; x; x -= 8)
-        {
-            *dest    = RGB8to32[*src];
-            dest[1]  = RGB8to32[src[1]];
-            dest[2]  = RGB8to32[src[2]];
-            dest[3]  = RGB8to32[src[3]];
-            dest[4]  = RGB8to32[src[4]];
-            dest[5]  = RGB8to32[src[5]];
-            dest[6]  = RGB8to32[src[6]];
-            dest[7]  = RGB8to32[src[7]];
-            src     += 8;
-            dest    += 8;
-        }
-        for(int i = d_remainder; i; i--)
-        {
-            *dest = RGB8to32[*src];
-            ++src;
-            ++dest;
-        }
-    }
+        I_ExpandPixels(src + y * screen->pitch, fb + y * destheight, screen->w, palette);
 }
 
 //
-// SDLGL2DVideoDriver::FinishUpdate
+// SDLGL2DVideoDriver::PresentFrame
 //
-void SDLGL2DVideoDriver::FinishUpdate()
+// Uploads an 8-bit frame and swaps it onto the window. Runs on whichever thread
+// holds the GL context.
+//
+void SDLGL2DVideoDriver::PresentFrame(const byte *src, const uint32_t *palette)
 {
-    // haleyjd 10/08/05: from Chocolate DOOM:
-    UpdateGrab(window);
-
-    // Don't update the screen if the window isn't visible.
-    // Not doing this breaks under Windows when we alt-tab away
-    // while fullscreen.
-    if(!(SDL_GetWindowFlags(window) & SDL_WINDOW_SHOWN) || I_IsViewOccluded())
-        return;
-
     GL_RebindBoundTexture();
 
     if(!use_arb_pbo)
     {
         // Convert the game's 8-bit output to the 32-bit texture buffer
-        DrawPixels(framebuffer, static_cast<unsigned int>(video.height));
+        DrawPixels(src, palette, framebuffer, static_cast<unsigned int>(video.height));
 
         // bind the framebuffer texture if necessary
         GL_BindTextureIfNeeded(textureid);
@@ -244,7 +237,7 @@ void SDLGL2DVideoDriver::FinishUpdate()
         if((ptr = pglMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB)))
         {
             // draw directly into video memory
-            DrawPixels(ptr, framebuffer_vmax);
+            DrawPixels(src, palette, ptr, framebuffer_vmax);
 
             // release pointer
             pglUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
@@ -261,6 +254,123 @@ void SDLGL2DVideoDriver::FinishUpdate()
     SDL_GL_SwapWindow(window);
 }
 
+//
+// SDLGL2DVideoDriver::PresentLoop
+//
+// Body of the present thread. Takes the GL context for itself and presents
+// queued frames in order until told to stop.
+//
+void SDLGL2DVideoDriver::PresentLoop()
+{
+    SDL_GL_MakeCurrent(window, glcontext);
+
+    std::unique_lock lock(presentmutex);
+    while(true)
+    {
+        presentcv.wait(lock, [] { return presentquit || queuedframes > 0; });
+        if(presentquit)
+            break;
+
+        const presentframe_t &frame = presentframes[presenthead];
+
+        // The game thread never touches the frame at the head of the queue
+        lock.unlock();
+        PresentFrame(frame.pixels, frame.palette);
+        lock.lock();
+
+        presenthead = (presenthead + 1) % NUMPRESENTFRAMES;
+        --queuedframes;
+        presentcv.notify_all();
+    }
+
+    SDL_GL_MakeCurrent(window, nullptr);
+}
+
+//
+// SDLGL2DVideoDriver::StartPresentThread
+//
+// Hands the GL context over to a new present thread, if so configured.
+//
+void SDLGL2DVideoDriver::StartPresentThread()
+{
+    if(!cfg_gl_present_thread)
+        return;
+
+    for(presentframe_t &frame : presentframes)
+        frame.pixels = ecalloc(byte *, screen->pitch, screen->h);
+
+    presenthead  = 0;
+    queuedframes = 0;
+    presentquit  = false;
+
+    SDL_GL_MakeCurrent(window, nullptr);
+    presentthread = std::thread(&SDLGL2DVideoDriver::PresentLoop, this);
+}
+
+//
+// SDLGL2DVideoDriver::StopPresentThread
+//
+// Stops the present thread, dropping any frames it hasn't shown yet, and takes
+// the GL context back.
+//
+void SDLGL2DVideoDriver::StopPresentThread()
+{
+    if(!presentthread.joinable())
+        return;
+
+    {
+        std::lock_guard lock(presentmutex);
+        presentquit = true;
+    }
+    presentcv.notify_all();
+    presentthread.join();
+
+    for(presentframe_t &frame : presentframes)
+    {
+        efree(frame.pixels);
+        frame.pixels = nullptr;
+    }
+
+    SDL_GL_MakeCurrent(window, glcontext);
+}
+
+//
+// SDLGL2DVideoDriver::FinishUpdate
+//
+void SDLGL2DVideoDriver::FinishUpdate()
+{
+    // haleyjd 10/08/05: from Chocolate DOOM:
+    UpdateGrab(window);
+
+    // Don't update the screen if the window isn't visible.
+    // Not doing this breaks under Windows when we alt-tab away
+    // while fullscreen.
+    if(!(SDL_GetWindowFlags(window) & SDL_WINDOW_SHOWN) || I_IsViewOccluded())
+        return;
+
+    if(!presentthread.joinable())
+    {
+        PresentFrame(static_cast<byte *>(screen->pixels), RGB8to32);
+        return;
+    }
+
+    // Queue a copy of the frame for the present thread. If the queue is full,
+    // the newest waiting frame is replaced instead, so the game never waits on
+    // the display.
+    std::unique_lock lock(presentmutex);
+    if(queuedframes == NUMPRESENTFRAMES)
+        --queuedframes;
+    presentframe_t &frame = presentframes[(presenthead + queuedframes) % NUMPRESENTFRAMES];
+    lock.unlock();
+
+    memcpy(frame.pixels, screen->pixels, screen->pitch * screen->h);
+    memcpy(frame.palette, RGB8to32, sizeof(RGB8to32));
+
+    lock.lock();
+    ++queuedframes;
+    presentcv.notify_all();
+}
+
 //
 // SDLGL2DVideoDriver::ReadScreen
 //
@@ -362,6 +472,9 @@ void SDLGL2DVideoDriver::ShutdownGraphicsPartway()
     // haleyjd 06/21/06: use UpdateGrab here, not release
     UpdateGrab(window);
 
+    // The context must be back on this thread before anything is torn down
+    StopPresentThread();
+
     // Code to allow changing resolutions in OpenGL.
     // Must shutdown everything.
 
@@ -684,6 +797,8 @@ bool SDLGL2DVideoDriver::InitGraphicsMode()
     // Set initial palette
     SetPalette(static_cast<byte *>(wGlobalDir.cacheLumpName("PLAYPAL", PU_CACHE)));
 
+    StartPresentThread();
+
     // Update the i_videomode cvar to correspond to the real state
     efree(i_videomode);
     i_videomode = geom.toString().duplicate();
@@ -38,9 +38,14 @@ class SDLGL2DVideoDriver : public HALVideoDriver
 protected:
     int colordepth;
 
-    void DrawPixels(void *buffer, unsigned int destheight);
+    void DrawPixels(const byte *src, const uint32_t *palette, void *buffer, unsigned int destheight);
+    void PresentFrame(const byte *src, const uint32_t *palette);
     void LoadPBOExtension();
 
+    void PresentLoop();
+    void StartPresentThread();
+    void StopPresentThread();
+
     virtual void SetPrimaryBuffer();
     virtual void UnsetPrimaryBuffer();
 
@@ -24,6 +24,7 @@
 #include "SDL.h"
 
 #include "../hal/i_platform.h"
+#include "../hal/i_present.h"
 
 #include "../z_zone.h" /* memory allocation wrappers -- killough */
 
@@ -60,7 +61,6 @@ void UpdateFocus(SDL_Window *window);
 //
 
 static SDL_Surface  *primary_surface;
-static SDL_Surface  *rgba_surface;
 static SDL_Texture  *sdltexture; // the texture to use for rendering
 static SDL_Renderer *renderer;
 static SDL_Rect     *destrect;
@@ -74,12 +74,26 @@ extern bool noblit;
 static SDL_Color basepal[256], colors[256];
 static bool      setpalette = false;
 
+// colors, packed in the streaming texture's pixel format
+static Uint32 texturepal[256];
+
 extern char *i_resolution;
 extern char *i_videomode;
 
 // MaxW: 2017/10/20: display number
 int displaynum = 0;
 
+//
+// I_SDLPackPalette
+//
+// Packs the gamma-corrected colors into texture pixels.
+//
+static void I_SDLPackPalette()
+{
+    for(int i = 0; i < 256; i++)
+        texturepal[i] = 0xff000000u | (Uint32(colors[i].r) << 16) | (Uint32(colors[i].g) << 8) | Uint32(colors[i].b);
+}
+
 //
 // SDLVideoDriver::FinishUpdate
 //
@@ -98,18 +112,24 @@ void SDLVideoDriver::FinishUpdate()
 
     if(setpalette)
     {
-        if(primary_surface)
-            SDL_SetPaletteColors(primary_surface->format->palette, colors, 0, 256);
-
+        I_SDLPackPalette();
         setpalette = false;
     }
 
     // haleyjd 11/12/09: blit *after* palette set improves behavior.
     if(primary_surface)
     {
-        // Don't bother checking for errors. It should just cancel itself in that case.
-        SDL_BlitSurface(primary_surface, nullptr, rgba_surface, nullptr);
-        SDL_UpdateTexture(sdltexture, nullptr, rgba_surface->pixels, rgba_surface->pitch);
+        void *pixels;
+        int   pitch;
+
+        // Expand and transpose the column-major frame straight into the texture, rather than going through a
+        // 32-bit surface and a rotated copy. Don't bother checking for errors otherwise.
+        if(!SDL_LockTexture(sdltexture, nullptr, &pixels, &pitch))
+        {
+            I_ExpandTransposed(static_cast<const byte *>(primary_surface->pixels), primary_surface->pitch,
+                               primary_surface->h, primary_surface->w, texturepal, pixels, pitch);
+            SDL_UnlockTexture(sdltexture);
+        }
 #if EE_CURRENT_PLATFORM == EE_PLATFORM_MACOSX
 #ifdef __arm64__
         // Must clear the renderer on ARM Apple systems, otherwise we get random garbled view on the
@@ -118,7 +138,7 @@ void SDLVideoDriver::FinishUpdate()
         SDL_RenderClear(renderer);
 #endif
 #endif
-        SDL_RenderCopyEx(renderer, sdltexture, nullptr, destrect, 90.0, nullptr, SDL_FLIP_VERTICAL);
+        SDL_RenderCopy(renderer, sdltexture, nullptr, destrect);
     }
 
     // haleyjd 11/12/09: ALWAYS update. Causes problems with some video surface
@@ -154,8 +174,7 @@ static void I_SDLSetPaletteDirect(byte *palette)
         colors[i].b = gammatable[usegamma][(basepal[i].b = *palette++)];
     }
 
-    if(primary_surface)
-        SDL_SetPaletteColors(primary_surface->format->palette, colors, 0, 256);
+    I_SDLPackPalette();
 }
 
 //
@@ -201,11 +220,6 @@ void SDLVideoDriver::UnsetPrimaryBuffer()
         SDL_DestroyTexture(sdltexture);
         sdltexture = nullptr;
     }
-    if(rgba_surface)
-    {
-        SDL_FreeSurface(rgba_surface);
-        rgba_surface = nullptr;
-    }
     if(primary_surface)
     {
         SDL_FreeSurface(primary_surface);
@@ -232,17 +246,9 @@ void SDLVideoDriver::SetPrimaryBuffer()
         if(!primary_surface)
             I_Error("SDLVideoDriver::SetPrimaryBuffer: failed to create screen temp buffer\n");
 
-        Uint32 pixelformat = SDL_GetWindowPixelFormat(window);
-        if(pixelformat == SDL_PIXELFORMAT_UNKNOWN)
-            pixelformat = SDL_PIXELFORMAT_RGBA32;
-
-        rgba_surface = SDL_CreateRGBSurfaceWithFormat(0, video.height, video.width + bump, 0, pixelformat);
-        if(!rgba_surface)
-        {
-            I_Error("SDLVideoDriver::SetPrimaryBuffer: failed to create true-colour buffer: %s\n", SDL_GetError());
-        }
-        sdltexture =
-            SDL_CreateTexture(renderer, pixelformat, SDL_TEXTUREACCESS_STREAMING, video.height, video.width + bump);
+        // The texture is upright: FinishUpdate transposes the frame while expanding it
+        sdltexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                       video.width + bump, video.height);
         if(!sdltexture)
         {
             I_Error("SDLVideoDriver::SetPrimaryBuffer: failed to create rendering texture: %s\n", SDL_GetError());
@@ -456,10 +462,10 @@ bool SDLVideoDriver::InitGraphicsMode()
     {
         const int letterboxHeight = I_VideoLetterboxHeight(resolutionWidth);
 
-        staticDestRect.x = (bumpedWidth - letterboxHeight) / 2;
-        staticDestRect.y = I_VideoLetterboxOffset(geom.height, bumpedWidth);
-        staticDestRect.w = letterboxHeight;
-        staticDestRect.h = bumpedWidth;
+        staticDestRect.x = 0;
+        staticDestRect.y = I_VideoLetterboxOffset(geom.height, letterboxHeight);
+        staticDestRect.w = bumpedWidth;
+        staticDestRect.h = letterboxHeight;
 
         video.width  = resolutionWidth;
         video.height = letterboxHeight;
@@ -467,10 +473,10 @@ bool SDLVideoDriver::InitGraphicsMode()
     }
     else
     {
-        staticDestRect.x = (bumpedWidth - geom.height) / 2;
-        staticDestRect.y = (geom.height - bumpedWidth) / 2;
-        staticDestRect.w = geom.height;
-        staticDestRect.h = bumpedWidth;
+        staticDestRect.x = 0;
+        staticDestRect.y = 0;
+        staticDestRect.w = bumpedWidth;
+        staticDestRect.h = geom.height;
 
         video.width  = resolutionWidth;
         video.height = resolutionHeight;
@@ -950,10 +950,135 @@ static void ST_doRefresh()
     ST_refreshBackground();
 
     // and refresh all widgets
-    ST_updateWidgets();
     ST_drawWidgets();
 }
 
+//
+// Status bar layer
+//
+// The status bar sits below the 3D view, and on most frames nothing it shows
+// has changed. Its last drawing is kept in a layer, and while every value the
+// bar's widgets show stays the same the layer is copied back to the screen
+// instead of redrawing the bar. Anything drawn over the bar since (menus, the
+// console) is covered again by the copy, just as a redraw would.
+//
+
+bool st_cachebar = true;
+
+//
+// Everything that goes into drawing the bar. Two frames with the same state
+// draw the same bar.
+//
+struct stlayerstate_t
+{
+    int      width, height; // screen
+    patch_t *sbar, *faceback;
+    patch_t *const *faces;
+    int      colormap;
+    int      gametype;
+    bool     statusbaron, armson, fragson, notdeathmatch;
+    int      ready, readymax, health, armor, frags, faceindex;
+    int      ammo[NUMAMMO], maxammo[NUMAMMO];
+    int      keyboxes[3];
+    int      weaponsowned[NUMWEAPONS];
+    int      colors[10]; // colour thresholds and settings
+};
+
+static stlayerstate_t st_layerstate;
+static bool           st_layervalid;
+static byte          *st_layer;
+static int            st_layerx1, st_layerx2, st_layery, st_layerh, st_layersize;
+
+//
+// Gets the current state of the bar. Returns false if the bar is showing
+// something that changes without its state changing, like the blinking
+// inventory bar.
+//
+static bool ST_getLayerState(stlayerstate_t &state)
+{
+    if(*w_invbarbg.on && *w_invbarbg.val)
+        return false;
+
+    memset(&state, 0, sizeof(state)); // padding is compared as well
+
+    state.width         = video.width;
+    state.height        = video.height;
+    state.sbar          = sbar;
+    state.faceback      = faceback;
+    state.faces         = players[displayplayer].skin->faces;
+    state.colormap      = plyr->colormap;
+    state.gametype      = GameType;
+    state.statusbaron   = st_statusbaron;
+    state.armson        = st_armson;
+    state.fragson       = st_fragson;
+    state.notdeathmatch = st_notdeathmatch;
+    state.ready         = w_ready.num;
+    state.readymax      = w_ready.max;
+    state.health        = w_health.n.num;
+    state.armor         = w_armor.n.num;
+    state.frags         = w_frags.num;
+    state.faceindex     = st_faceindex;
+
+    for(int i = 0; i < NUMAMMO; i++)
+    {
+        state.ammo[i]    = w_ammo[i].num;
+        state.maxammo[i] = w_maxammo[i].num;
+    }
+    memcpy(state.keyboxes, keyboxes, sizeof(keyboxes));
+    memcpy(state.weaponsowned, weaponsowned, sizeof(weaponsowned));
+
+    const int colors[] = { ammo_red,  ammo_yellow,  health_red,  health_yellow,  health_green,
+                           armor_red, armor_yellow, armor_green, sts_always_red, sts_pct_always_gray };
+    static_assert(sizeof(colors) == sizeof(state.colors));
+    memcpy(state.colors, colors, sizeof(colors));
+
+    return true;
+}
+
+//
+// Keeps what was just drawn of the bar in the layer.
+//
+static void ST_saveLayer(const stlayerstate_t &state)
+{
+    // The bar covers the 4:3 area, and the background may be wider still
+    const int sbarx = ST_X + (vbscreenyscaled.unscaledw - sbar->width) / 2;
+    const int sbarr = sbarx + sbar->width - 1;
+
+    st_layerx1 = subscreen43.subx;
+    st_layerx2 = subscreen43.subx + subscreen43.width;
+    if(sbarx < vbscreenyscaled.unscaledw && sbarr >= 0)
+    {
+        st_layerx1 = emin(st_layerx1, vbscreenyscaled.x1lookup[emax(sbarx, 0)]);
+        st_layerx2 = emax(st_layerx2, vbscreenyscaled.x2lookup[emin(sbarr, vbscreenyscaled.unscaledw - 1)] + 1);
+    }
+    st_layery = vbscreenyscaled.y1lookup[ST_Y];
+    st_layerh = vbscreen.height - st_layery;
+
+    const int size = (st_layerx2 - st_layerx1) * st_layerh;
+    if(size > st_layersize)
+    {
+        st_layer     = erealloc(byte *, st_layer, size);
+        st_layersize = size;
+    }
+
+    byte *dest = st_layer;
+    for(int x = st_layerx1; x < st_layerx2; x++, dest += st_layerh)
+        memcpy(dest, VBADDRESS(&vbscreen, x, st_layery), st_layerh);
+
+    st_layerstate = state;
+    st_layervalid = true;
+}
+
+//
+// Copies the layer back to the screen.
+//
+static void ST_drawLayer()
+{
+    const byte *src = st_layer;
+    for(int x = st_layerx1; x < st_layerx2; x++, src += st_layerh)
+        memcpy(VBADDRESS(&vbscreen, x, st_layery), src, st_layerh);
+}
+
 // Locations for graphical HUD elements
 
 #define ST_FS_X 85
@@ -1018,7 +1143,21 @@ static void ST_DoomDrawer()
     // possibly update widget positions
     ST_moveWidgets(false);
 
+    ST_updateWidgets();
+
+    stlayerstate_t state;
+    const bool     cacheable = st_cachebar && ST_getLayerState(state);
+
+    if(cacheable && st_layervalid && !memcmp(&state, &st_layerstate, sizeof(state)))
+    {
+        ST_drawLayer();
+        return;
+    }
+
     ST_doRefresh(); // If just after ST_Start(), refresh all
+
+    if(cacheable)
+        ST_saveLayer(state);
 }
 
 #define ST_ALPHA (st_fsalpha * FRACUNIT / 100)
@@ -1158,6 +1297,7 @@ static void ST_loadGraphics()
     char namebuf[9];
 
     ST_unloadOldGraphics(default_faces);
+    st_layervalid = false;
 
     // Load the numbers, tall and short
     for(i = 0; i < 10; i++)
@@ -1406,6 +1546,7 @@ static void ST_createWidgets()
 //
 static void ST_DoomStart()
 {
+    st_layervalid = false;
     ST_initData();
     ST_createWidgets();
 }
@@ -1495,6 +1636,8 @@ VARIABLE_BOOLEAN(sts_traditional_keys,     nullptr,yesno);
 
 VARIABLE_INT(st_fsalpha, nullptr,          0, 100, nullptr);
 
+VARIABLE_TOGGLE(st_cachebar, nullptr,      onoff);
+
 CONSOLE_VARIABLE(ammo_red,      ammo_red,      0) {}
 CONSOLE_VARIABLE(ammo_yellow,   ammo_yellow,   0) {}
 CONSOLE_VARIABLE(health_red,    health_red,    0) {}
@@ -1509,6 +1652,7 @@ CONSOLE_VARIABLE(st_graypct,   sts_pct_always_gray,  0) {}
 CONSOLE_VARIABLE(st_rednum,    sts_always_red,       0) {}
 CONSOLE_VARIABLE(st_singlekey, sts_traditional_keys, 0) {}
 CONSOLE_VARIABLE(st_fsalpha,   st_fsalpha,           0) {}
+CONSOLE_VARIABLE(st_cachebar,  st_cachebar,          0) {}
 
 // clang-format on
 
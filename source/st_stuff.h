@@ -105,6 +105,7 @@ extern int  sts_always_red;       // status numbers do not change colors
 extern int  sts_pct_always_gray;  // status percents do not change colors
 extern int  sts_traditional_keys; // display keys the traditional way
 extern int  st_fsalpha;           // haleyjd 02/27/10: fullscreen hud alpha
+extern bool st_cachebar;          // reuse the last drawing of an unchanged status bar
 
 // Number of status faces.
 static constexpr int ST_NUMPAINFACES     = 5;
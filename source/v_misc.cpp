@@ -545,6 +545,9 @@ void V_Init()
     VAllocItem::FreeAllocs();
     VAllocItem::SetNewMode(video.width, video.height);
 
+    // scaled patches are only good for the mode they were scaled to
+    V_FlushPatchCache();
+
     if(s)
         efree(s);
 
@@ -583,7 +586,7 @@ void V_DrawBackground(const char *patchname, VBuffer *back_dest)
     back_dest->TileBlock64(back_dest, src);
 }
 
-byte *R_DistortedFlat(ZoneHeap &heap, int, bool);
+byte *R_DistortedFlat(int, bool);
 
 //
 // V_DrawDistortedBackground
@@ -595,7 +598,7 @@ void V_DrawDistortedBackground(const char *patchname, VBuffer *back_dest)
 {
     const int patchNum = R_FindFlat(patchname);
     R_CacheTexture(patchNum);
-    const byte *src = R_DistortedFlat(*r_globalcontext.heap, patchNum, true);
+    const byte *src = R_DistortedFlat(patchNum, true);
 
     back_dest->TileBlock64(back_dest, src);
 }
@@ -0,0 +1,295 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Nearest palette colour searches over many colours at once, and an
+//  on-disk cache for the lookup tables built from them.
+//
+//  Each target colour gets a SIMD lane, and the palette is walked once for the
+//  whole batch, which keeps the results identical to a one-at-a-time search.
+//
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define V_PALMATCH_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define V_PALMATCH_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#include "z_zone.h"
+#include "hal/i_platform.h"
+
+#include "c_io.h"
+#include "c_runcmd.h"
+#include "doomstat.h"
+#include "m_qstr.h"
+#include "m_utils.h"
+#include "v_misc.h"
+#include "v_palmatch.h"
+
+bool v_tablecache = true;
+
+//
+// Matches a single colour.
+//
+static byte V_matchColor(const palmatch_t &match, int r, int g, int b)
+{
+    const int first = match.preferhigh ? 255 : 0;
+    const int step  = match.preferhigh ? -1 : 1;
+
+    int  best      = INT_MAX;
+    byte bestcolor = 0;
+    for(int i = 0, c = first; i < 256; i++, c += step)
+    {
+        const int err = match.tot[c] - match.pal[0][c] * r - match.pal[1][c] * g - match.pal[2][c] * b;
+        if(err < best)
+        {
+            best      = err;
+            bestcolor = byte(c);
+        }
+    }
+
+    return bestcolor;
+}
+
+#ifdef V_PALMATCH_SSE2
+//
+// 32-bit multiply of non-negative lanes, which SSE2 lacks
+//
+static inline __m128i V_mulSSE2(const __m128i a, const __m128i b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+//
+// Matches four colours at once.
+//
+static void V_matchColorsSSE2(const palmatch_t &match, const int *r, const int *g, const int *b, byte *dest)
+{
+    const __m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r));
+    const __m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(g));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+
+    const int first = match.preferhigh ? 255 : 0;
+    const int step  = match.preferhigh ? -1 : 1;
+
+    __m128i best      = _mm_set1_epi32(INT_MAX);
+    __m128i bestcolor = _mm_setzero_si128();
+    for(int i = 0, c = first; i < 256; i++, c += step)
+    {
+        __m128i err = _mm_set1_epi32(match.tot[c]);
+        err         = _mm_sub_epi32(err, V_mulSSE2(vr, _mm_set1_epi32(match.pal[0][c])));
+        err         = _mm_sub_epi32(err, V_mulSSE2(vg, _mm_set1_epi32(match.pal[1][c])));
+        err         = _mm_sub_epi32(err, V_mulSSE2(vb, _mm_set1_epi32(match.pal[2][c])));
+
+        const __m128i better = _mm_cmpgt_epi32(best, err);
+        best      = _mm_or_si128(_mm_and_si128(better, err), _mm_andnot_si128(better, best));
+        bestcolor = _mm_or_si128(_mm_and_si128(better, _mm_set1_epi32(c)), _mm_andnot_si128(better, bestcolor));
+    }
+
+    alignas(16) int result[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(result), bestcolor);
+    for(int i = 0; i < 4; i++)
+        dest[i] = byte(result[i]);
+}
+#endif
+
+#ifdef V_PALMATCH_AVX2
+#ifdef __GNUC__
+#define V_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define V_AVX2_TARGET
+#endif
+
+//
+// Matches eight colours at once.
+//
+V_AVX2_TARGET static void V_matchColorsAVX2(const palmatch_t &match, const int *r, const int *g, const int *b,
+                                            byte *dest)
+{
+    const __m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r));
+    const __m256i vg = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(g));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+
+    const int first = match.preferhigh ? 255 : 0;
+    const int step  = match.preferhigh ? -1 : 1;
+
+    __m256i best      = _mm256_set1_epi32(INT_MAX);
+    __m256i bestcolor = _mm256_setzero_si256();
+    for(int i = 0, c = first; i < 256; i++, c += step)
+    {
+        __m256i err = _mm256_set1_epi32(match.tot[c]);
+        err         = _mm256_sub_epi32(err, _mm256_mullo_epi32(vr, _mm256_set1_epi32(match.pal[0][c])));
+        err         = _mm256_sub_epi32(err, _mm256_mullo_epi32(vg, _mm256_set1_epi32(match.pal[1][c])));
+        err         = _mm256_sub_epi32(err, _mm256_mullo_epi32(vb, _mm256_set1_epi32(match.pal[2][c])));
+
+        const __m256i better = _mm256_cmpgt_epi32(best, err);
+        best      = _mm256_min_epi32(best, err);
+        bestcolor = _mm256_blendv_epi8(bestcolor, _mm256_set1_epi32(c), better);
+    }
+
+    alignas(32) int result[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(result), bestcolor);
+    for(int i = 0; i < 8; i++)
+        dest[i] = byte(result[i]);
+}
+#endif
+
+//
+// Finds the closest palette colour for count targets, given as separate
+// channel arrays, and stores the indices in dest. Targets and palette
+// channels must be non-negative, and no error may overflow an int.
+//
+void V_MatchColors(const palmatch_t &match, const int *r, const int *g, const int *b, int count, byte *dest)
+{
+    int i = 0;
+
+#ifdef V_PALMATCH_AVX2
+    static const bool hasavx2 = I_CPUHasAVX2();
+    if(hasavx2)
+    {
+        for(; i + 8 <= count; i += 8)
+            V_matchColorsAVX2(match, r + i, g + i, b + i, dest + i);
+    }
+#endif
+#ifdef V_PALMATCH_SSE2
+    for(; i + 4 <= count; i += 4)
+        V_matchColorsSSE2(match, r + i, g + i, b + i, dest + i);
+#endif
+    for(; i < count; i++)
+        dest[i] = V_matchColor(match, r[i], g[i], b[i]);
+}
+
+//=============================================================================
+//
+// Table cache
+//
+// Generated tables are saved in the user directory, in files named after the
+// table, a hash of the palette, and the parameter they were built with. The
+// header repeats the whole palette and parameter, so a hash collision can only
+// cost a rebuild.
+//
+
+static constexpr char TABLECACHE_MAGIC[4] = { 'E', 'E', 'T', 'B' };
+static constexpr int  TABLECACHE_VERSION  = 1;
+
+struct tablecacheheader_t
+{
+    char    magic[4];
+    int32_t version;
+    int32_t param;
+    int32_t size;
+    byte    palette[768];
+};
+
+//
+// FNV-1a hash of a palette
+//
+static uint32_t V_hashPalette(const byte *palette)
+{
+    uint32_t hash = 2166136261u;
+    for(int i = 0; i < 768; i++)
+        hash = (hash ^ palette[i]) * 16777619u;
+    return hash;
+}
+
+//
+// Gets the cache file path for a table
+//
+static qstring V_tableCachePath(const char *name, const byte *palette, int param)
+{
+    qstring filename;
+    filename.Printf(64, "%s-%08x-%d.dat", name, V_hashPalette(palette), param);
+
+    return qstring(userpath).pathConcatenate(filename);
+}
+
+//
+// Fills the header describing a table
+//
+static void V_setupTableHeader(tablecacheheader_t &header, const byte *palette, int param, size_t size)
+{
+    memcpy(header.magic, TABLECACHE_MAGIC, sizeof(header.magic));
+    header.version = TABLECACHE_VERSION;
+    header.param   = param;
+    header.size    = int32_t(size);
+    memcpy(header.palette, palette, sizeof(header.palette));
+}
+
+//
+// Loads a table built earlier for this palette and parameter. Returns false,
+// leaving the table alone, if there isn't a matching one on disk.
+//
+bool V_LoadColorTable(const char *name, const byte *palette, int param, byte *table, size_t size)
+{
+    if(!v_tablecache || !userpath)
+        return false;
+
+    const qstring path = V_tableCachePath(name, palette, param);
+
+    byte     *buffer = nullptr;
+    const int length = M_ReadFile(path.constPtr(), &buffer);
+    if(length < 0)
+        return false;
+
+    tablecacheheader_t expected;
+    V_setupTableHeader(expected, palette, param, size);
+
+    const bool valid = size_t(length) == sizeof(expected) + size && !memcmp(buffer, &expected, sizeof(expected));
+    if(valid)
+        memcpy(table, buffer + sizeof(expected), size);
+
+    efree(buffer);
+    return valid;
+}
+
+//
+// Saves a freshly built table for V_LoadColorTable to find next time.
+//
+void V_SaveColorTable(const char *name, const byte *palette, int param, const byte *table, size_t size)
+{
+    if(!v_tablecache || !userpath)
+        return;
+
+    tablecacheheader_t header;
+    V_setupTableHeader(header, palette, param, size);
+
+    byte *buffer = emalloc(byte *, sizeof(header) + size);
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), table, size);
+
+    const qstring path = V_tableCachePath(name, palette, param);
+    if(!M_WriteFile(path.constPtr(), buffer, sizeof(header) + size))
+        C_Printf(FC_ERROR "Couldn't write %s\a\n", path.constPtr());
+
+    efree(buffer);
+}
+
+VARIABLE_TOGGLE(v_tablecache, nullptr, onoff);
+CONSOLE_VARIABLE(v_tablecache, v_tablecache, 0) {}
+
+// EOF
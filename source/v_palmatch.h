@@ -0,0 +1,53 @@
+//
+// The Eternity Engine
+// Copyright (C) 2025 James Haley et al.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+//------------------------------------------------------------------------------
+//
+// Purpose: Nearest palette colour searches over many colours at once, and an
+//  on-disk cache for the lookup tables built from them.
+//
+
+#ifndef V_PALMATCH_H__
+#define V_PALMATCH_H__
+
+#include "doomtype.h"
+
+//
+// A palette prepared for matching. The error of colour c against a target
+// (r, g, b) is tot[c] - pal[0][c] * r - pal[1][c] * g - pal[2][c] * b, and the
+// colour with the lowest error wins.
+//
+struct palmatch_t
+{
+    int  tot[256];
+    int  pal[3][256];
+    bool preferhigh; // on a tie, pick the highest index rather than the lowest
+};
+
+void V_MatchColors(const palmatch_t &match, const int *r, const int *g, const int *b, int count, byte *dest);
+
+bool V_LoadColorTable(const char *name, const byte *palette, int param, byte *table, size_t size);
+void V_SaveColorTable(const char *name, const byte *palette, int param, const byte *table, size_t size);
+
+extern bool v_tablecache;
+
+#endif
+
+// EOF
@@ -25,6 +25,7 @@
 #include "i_system.h"
 
 #include "c_io.h"
+#include "c_runcmd.h"
 #include "m_collection.h"
 #include "m_compare.h"
 #include "m_swap.h"
@@ -524,7 +525,8 @@ static patchcolfunc_t colfuncfordrawstyle[PSTYLE_NUMSTYLES] = {
 // eliminates mostly unnecessary special cases for certain resolutions
 // like 640x400.
 //
-void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer)
+static void V_drawPatchColumns(cb_patch_column_t &patchcol, const PatchInfo *pi, VBuffer *buffer,
+                               patchcolfunc_t colfunc)
 {
     int      x1, x2, w;
     fixed_t  iscale, xiscale, startfrac = 0;
@@ -619,11 +621,7 @@ void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer)
         column_t *column;
         int       texturecolumn;
 
-#ifdef RANGECHECK
-        if(pi->drawstyle < 0 || pi->drawstyle >= PSTYLE_NUMSTYLES)
-            I_Error("V_DrawPatchInt: unknown patch drawstyle %d\n", pi->drawstyle);
-#endif
-        patchcol.colfunc = colfuncfordrawstyle[pi->drawstyle];
+        patchcol.colfunc = colfunc;
 
         const int ytop = pi->y - patch->topoffset;
         for(; patchcol.x <= x2; patchcol.x++, startfrac += xiscale)
@@ -636,7 +634,7 @@ void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer)
 
 #ifdef RANGECHECK
             if(texturecolumn < 0 || texturecolumn >= w)
-                I_Error("V_DrawPatchInt: bad texturecolumn %d\n", texturecolumn);
+                I_Error("V_drawPatchColumns: bad texturecolumn %d\n", texturecolumn);
 #endif
 
             column = (column_t *)((byte *)patch + patch->columnofs[texturecolumn]);
@@ -645,6 +643,305 @@ void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer)
     }
 }
 
+//=============================================================================
+//
+// Scaled Patch Cache
+//
+// The HUD, menus and fonts draw the same patches at the same places every
+// frame, and at high resolutions most of the cost is the scaling DDA. Once a
+// patch has been drawn twice at one spot on a scaled buffer, the pixels that
+// scaling picks out of it are kept as runs of screen columns, and later draws
+// only have to copy (or translate, or blend) those runs.
+//
+// What scaling produces depends on the buffer's geometry and the position, not
+// on which buffer is drawn to, so entries are keyed on those and the patch's
+// address. Patches live in cached lumps, which only go away when the zone frees
+// them, so the whole cache is dropped whenever the zone's owner generation
+// moves on. Entries which go a while without being drawn are dropped too.
+//
+
+bool v_patchcache = true;
+
+static constexpr int          NUMPATCHCACHECHAINS = 512;
+static constexpr size_t       PATCHCACHEBUDGET    = 32 * 1024 * 1024;
+static constexpr unsigned int PATCHCACHESWEEP     = 4096; // draws between sweeps for stale entries
+
+struct patchspan_t
+{
+    int16_t  x, y1, y2;
+    uint32_t offset; // into the entry's pixels
+};
+
+struct patchcacheentry_t
+{
+    patchcacheentry_t *next;
+
+    const patch_t *patch;
+    int            x, y;
+    bool           flipped;
+    int            width, height, unscaledw, unscaledh; // buffer geometry
+
+    unsigned int lastused; // patchcacheclock when last drawn
+    bool         seen;     // drawn once already
+    bool         built;    // runs have been captured
+    bool         toobig;   // not worth its space in the cache
+    int          numspans;
+    size_t       size; // of the spans and pixels
+    patchspan_t *spans;
+    byte        *pixels;
+};
+
+static patchcacheentry_t *patchcache[NUMPATCHCACHECHAINS];
+static size_t             patchcachesize;
+static unsigned int       patchcacheclock;      // counts draws through the cache
+static unsigned int       patchcachegeneration; // zone owner generation it's valid for
+
+// Runs and pixels captured while building an entry
+static PODCollection<patchspan_t> capturespans;
+static PODCollection<byte>        capturepixels;
+
+//
+// Stands in for a column drawer while an entry is built, keeping the pixels
+// the drawer would have picked instead of writing them.
+//
+static void V_capturePatchColumn(const cb_patch_column_t &patchcol)
+{
+    int count;
+
+    if((count = patchcol.y2 - patchcol.y1 + 1) <= 0)
+        return;
+
+    const fixed_t fracstep = patchcol.step;
+    fixed_t       frac     = patchcol.frac + ((patchcol.y1 * fracstep) & 0xFFFF);
+
+    patchspan_t span;
+    span.x      = int16_t(patchcol.x);
+    span.y1     = int16_t(patchcol.y1);
+    span.y2     = int16_t(patchcol.y2);
+    span.offset = uint32_t(capturepixels.getLength());
+    capturespans.add(span);
+
+    while(count--)
+    {
+        capturepixels.add(patchcol.source[frac >> FRACBITS]);
+        frac += fracstep;
+    }
+}
+
+//
+// Frees one entry, which must already be unlinked.
+//
+static void V_freePatchCacheEntry(patchcacheentry_t *entry)
+{
+    patchcachesize -= sizeof(patchcacheentry_t) + entry->size;
+    if(entry->spans)
+        efree(entry->spans);
+    efree(entry);
+}
+
+//
+// Frees every entry in the cache.
+//
+void V_FlushPatchCache()
+{
+    for(patchcacheentry_t *&chain : patchcache)
+    {
+        while(chain)
+        {
+            patchcacheentry_t *next = chain->next;
+            V_freePatchCacheEntry(chain);
+            chain = next;
+        }
+    }
+    patchcachesize = 0;
+}
+
+//
+// Frees the entries which haven't been drawn since the last sweep, such as
+// those for text that scrolled past.
+//
+static void V_sweepPatchCache()
+{
+    for(patchcacheentry_t *&chain : patchcache)
+    {
+        for(patchcacheentry_t **link = &chain; *link;)
+        {
+            patchcacheentry_t *entry = *link;
+            if(patchcacheclock - entry->lastused > PATCHCACHESWEEP)
+            {
+                *link = entry->next;
+                V_freePatchCacheEntry(entry);
+            }
+            else
+                link = &entry->next;
+        }
+    }
+}
+
+//
+// Finds the entry for a patch drawn at a given spot, or adds an unbuilt one.
+//
+static patchcacheentry_t *V_findPatchCacheEntry(const PatchInfo *pi, const VBuffer *buffer)
+{
+    const uintptr_t key   = uintptr_t(pi->patch) ^ (uintptr_t(pi->patch) >> 7);
+    const unsigned  chain = unsigned(key + pi->x * 31 + pi->y * 131 + pi->flipped) % NUMPATCHCACHECHAINS;
+
+    for(patchcacheentry_t *entry = patchcache[chain]; entry; entry = entry->next)
+    {
+        if(entry->patch == pi->patch && entry->x == pi->x && entry->y == pi->y && entry->flipped == pi->flipped &&
+           entry->width == buffer->width && entry->height == buffer->height &&
+           entry->unscaledw == buffer->unscaledw && entry->unscaledh == buffer->unscaledh)
+        {
+            entry->lastused = patchcacheclock;
+            return entry;
+        }
+    }
+
+    if(patchcachesize + sizeof(patchcacheentry_t) > PATCHCACHEBUDGET)
+        V_FlushPatchCache();
+
+    auto entry       = estructalloc(patchcacheentry_t, 1);
+    entry->patch     = pi->patch;
+    entry->x         = pi->x;
+    entry->y         = pi->y;
+    entry->flipped   = pi->flipped;
+    entry->width     = buffer->width;
+    entry->height    = buffer->height;
+    entry->unscaledw = buffer->unscaledw;
+    entry->unscaledh = buffer->unscaledh;
+    entry->lastused  = patchcacheclock;
+
+    entry->next       = patchcache[chain];
+    patchcache[chain] = entry;
+
+    patchcachesize += sizeof(patchcacheentry_t);
+
+    return entry;
+}
+
+//
+// Runs the scaling once more to capture the patch's runs into the entry.
+// Returns false if it wouldn't fit in the cache.
+//
+static bool V_buildPatchCacheEntry(patchcacheentry_t *entry, cb_patch_column_t &patchcol, const PatchInfo *pi,
+                                   VBuffer *buffer)
+{
+    capturespans.makeEmpty();
+    capturepixels.makeEmpty();
+
+    V_drawPatchColumns(patchcol, pi, buffer, V_capturePatchColumn);
+
+    const size_t numspans  = capturespans.getLength();
+    const size_t numpixels = capturepixels.getLength();
+    const size_t size      = numspans * sizeof(patchspan_t) + numpixels;
+
+    // Don't let one huge patch push everything else out
+    if(size > PATCHCACHEBUDGET / 4)
+    {
+        entry->toobig = true;
+        return false;
+    }
+    if(patchcachesize + size > PATCHCACHEBUDGET)
+    {
+        V_FlushPatchCache();
+        return false;
+    }
+
+    entry->built    = true;
+    entry->numspans = int(numspans);
+    entry->size     = size;
+    if(size)
+    {
+        entry->spans  = emalloc(patchspan_t *, size);
+        entry->pixels = reinterpret_cast<byte *>(entry->spans + numspans);
+        memcpy(entry->spans, &capturespans[0], numspans * sizeof(patchspan_t));
+        memcpy(entry->pixels, &capturepixels[0], numpixels);
+    }
+    patchcachesize += size;
+
+    return true;
+}
+
+//
+// Draws a built entry, which is already at the buffer's scale.
+//
+static void V_drawPatchCacheEntry(const patchcacheentry_t *entry, cb_patch_column_t &patchcol, int drawstyle,
+                                  VBuffer *buffer)
+{
+    if(drawstyle == PSTYLE_NORMAL)
+    {
+        for(const patchspan_t *span = entry->spans; span != entry->spans + entry->numspans; span++)
+            memcpy(VBADDRESS(buffer, span->x, span->y1), entry->pixels + span->offset, span->y2 - span->y1 + 1);
+        return;
+    }
+
+    patchcol.buffer  = buffer;
+    patchcol.colfunc = colfuncfordrawstyle[drawstyle];
+    patchcol.step    = FRACUNIT;
+    patchcol.frac    = 0;
+
+    for(const patchspan_t *span = entry->spans; span != entry->spans + entry->numspans; span++)
+    {
+        patchcol.x      = span->x;
+        patchcol.y1     = span->y1;
+        patchcol.y2     = span->y2;
+        patchcol.source = entry->pixels + span->offset;
+        patchcol.colfunc(patchcol);
+    }
+}
+
+//
+// Draws a patch, going through the scaled patch cache when the buffer is
+// scaled.
+//
+void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer)
+{
+#ifdef RANGECHECK
+    if(pi->drawstyle < 0 || pi->drawstyle >= PSTYLE_NUMSTYLES)
+        I_Error("V_DrawPatchInt: unknown patch drawstyle %d\n", pi->drawstyle);
+#endif
+
+    if(v_patchcache && buffer->scaled)
+    {
+        // A freed lump may have left a different patch at the same address
+        const unsigned int generation = z_globalheap.ownerGeneration();
+        if(generation != patchcachegeneration)
+        {
+            V_FlushPatchCache();
+            patchcachegeneration = generation;
+        }
+        else if(++patchcacheclock % PATCHCACHESWEEP == 0)
+            V_sweepPatchCache();
+
+        patchcacheentry_t *entry = V_findPatchCacheEntry(pi, buffer);
+
+        // Patches drawn only once somewhere, like scrolling text, aren't
+        // worth capturing, so entries are only built on their second draw.
+        // Building may flush the cache, entry included.
+        if(!entry->built && !entry->toobig)
+        {
+            if(!entry->seen)
+                entry->seen = true;
+            else if(!V_buildPatchCacheEntry(entry, patchcol, pi, buffer))
+                entry = nullptr;
+        }
+
+        if(entry && entry->built)
+        {
+            V_drawPatchCacheEntry(entry, patchcol, pi->drawstyle, buffer);
+            return;
+        }
+    }
+
+    V_drawPatchColumns(patchcol, pi, buffer, colfuncfordrawstyle[pi->drawstyle]);
+}
+
+VARIABLE_TOGGLE(v_patchcache, nullptr, onoff);
+CONSOLE_VARIABLE(v_patchcache, v_patchcache, 0)
+{
+    V_FlushPatchCache();
+}
+
 //
 // V_SetupBufferFuncs
 //
@@ -54,6 +54,9 @@ enum
 };
 
 void V_DrawPatchInt(cb_patch_column_t &patchcol, PatchInfo *pi, VBuffer *buffer);
+void V_FlushPatchCache();
+
+extern bool v_patchcache;
 
 enum
 {
@@ -897,25 +897,19 @@ static void V_pngRemoveFile(pngwrite_t *writeData, const char *filename)
 }
 
 //
-// V_WritePNG
+// V_writePNG
 //
-// Write a linear graphic as a PNG file.
+// Write a linear graphic as a PNG file with the given palette.
 //
-bool V_WritePNG(byte *linear, int width, int height, const char *filename)
+static bool V_writePNG(byte *linear, int width, int height, const char *filename, const byte *palette)
 {
-    AutoPalette palcache(wGlobalDir);
     png_structp pngStruct;
     png_infop   pngInfo;
     png_colorp  pngPalette;
     pngwrite_t  writeData;
     bool        libpngError = false;
     bool        retval;
-
-    byte  *palette;
-    byte **rowpointers;
-
-    // Load palette
-    palette = palcache.get();
+    byte      **rowpointers;
 
     // Open file for output
     if(!(writeData.outf = I_fopen(filename, "wb")))
@@ -1005,5 +999,23 @@ bool V_WritePNG(byte *linear, int width, int height, const char *filename)
     return retval;
 }
 
+//
+// V_WritePNG
+//
+// Write a linear graphic as a PNG file. The game's PLAYPAL is used unless
+// another palette is given. The WAD is only touched for the PLAYPAL, so a
+// caller passing its own palette may write from any thread.
+//
+bool V_WritePNG(byte *linear, int width, int height, const char *filename, const byte *pal)
+{
+    if(!pal)
+    {
+        AutoPalette palcache(wGlobalDir);
+        return V_writePNG(linear, width, height, filename, palcache.get());
+    }
+
+    return V_writePNG(linear, width, height, filename, pal);
+}
+
 // EOF
 
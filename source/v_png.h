@@ -74,7 +74,7 @@ public:
     static patch_t *LoadAsPatch(const char *lumpname, int tag, void **user = nullptr, size_t *size = nullptr);
 };
 
-bool V_WritePNG(byte *linear, int width, int height, const char *filename);
+bool V_WritePNG(byte *linear, int width, int height, const char *filename, const byte *pal = nullptr);
 
 #endif
 
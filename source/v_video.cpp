@@ -37,6 +37,7 @@
 #include "r_patch.h"
 #include "v_block.h"
 #include "v_misc.h"
+#include "v_palmatch.h"
 #include "v_patchfmt.h"
 #include "v_video.h"
 #include "w_wad.h" /* needed for color translation lump lookup */
@@ -814,15 +815,39 @@ void V_InitFlexTranTable(const byte *palette)
     }
 
     // build RGB table
-    for(r = 0; r < 32; ++r)
+    if(!V_LoadColorTable("rgb32k", palette, 0, &RGB32k[0][0][0], sizeof(RGB32k)))
     {
-        for(g = 0; g < 32; ++g)
+        // Same search as V_FindBestColor, a row of blues at a time: dropping
+        // the constant target term leaves |p|^2 - 2 * p . t to minimize.
+        palmatch_t match;
+        int        tr[32], tg[32], tb[32];
+
+        for(i = 0, palRover = palette; i < 256; i++, palRover += 3)
+        {
+            match.pal[0][i] = palRover[0];
+            match.pal[1][i] = palRover[1];
+            match.pal[2][i] = palRover[2];
+            match.tot[i]    = palRover[0] * palRover[0] + palRover[1] * palRover[1] + palRover[2] * palRover[2];
+        }
+        match.preferhigh = false;
+
+        for(b = 0; b < 32; ++b)
+            tb[b] = 2 * MAKECOLOR(b);
+
+        for(r = 0; r < 32; ++r)
         {
-            for(b = 0; b < 32; ++b)
+            for(g = 0; g < 32; ++g)
             {
-                RGB32k[r][g][b] = V_FindBestColor(palette, MAKECOLOR(r), MAKECOLOR(g), MAKECOLOR(b));
+                for(b = 0; b < 32; ++b)
+                {
+                    tr[b] = 2 * MAKECOLOR(r);
+                    tg[b] = 2 * MAKECOLOR(g);
+                }
+                V_MatchColors(match, tr, tg, tb, 32, RGB32k[r][g]);
             }
         }
+
+        V_SaveColorTable("rgb32k", palette, 0, &RGB32k[0][0][0], sizeof(RGB32k));
     }
 
     // build lookup table
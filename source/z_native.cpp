@@ -37,12 +37,15 @@
 #include <mutex>
 
 #include "z_zone.h"
+#include "c_io.h"
 #include "i_system.h"
 #include "hal/i_directory.h"
 #include "doomstat.h"
 #include "m_argv.h"
+#include "m_compare.h"
 #include "m_qstr.h"
 #include "r_context.h"
+#include "v_misc.h"
 
 //=============================================================================
 //
@@ -121,6 +124,7 @@ static constexpr size_t header_size = (sizeof(memblock_t) + 15) & ~15;
 // ZoneObject class statics
 ZoneObject *ZoneObject::objectbytag[PU_MAX]; // like blockbytag but for objects
 void       *ZoneObject::newalloc;            // most recent ZoneObject alloc
+ZoneSlab   *ZoneObject::newslab;             // slab of the most recent alloc, if any
 
 //=============================================================================
 //
@@ -403,7 +407,10 @@ void ZoneHeapBase::free(void *p, const std::source_location loc)
         SCRAMBLER(p, block->size);
 
         if(block->user) // Nullify user if one exists
+        {
             *block->user = nullptr;
+            m_ownergeneration.fetch_add(1, std::memory_order_relaxed);
+        }
 
         if((*block->prev = block->next))
             block->next->prev = block->prev;
@@ -517,7 +524,10 @@ void *ZoneHeapBase::realloc(void *ptr, size_t n, int tag, void **user, const std
 
     // nullify current user, if any
     if(block->user)
+    {
         *(block->user) = nullptr;
+        m_ownergeneration.fetch_add(1, std::memory_order_relaxed);
+    }
 
     // detach from list before reallocation
     if((*block->prev = block->next))
@@ -1011,6 +1021,7 @@ void ZoneHeapThreadSafe::freeTags(int lowtag, int hightag, const std::source_loc
     // haleyjd 03/30/2011: delete ZoneObjects of the same tags as well
     // MaxW: 2023/03/31: But only if we're freeing tags from the global zone heap!
     ZoneObject::FreeTags(lowtag, hightag);
+    ZoneSlab::FreeTags(lowtag, hightag);
 
     ZoneHeapBase::freeTags(lowtag, hightag, loc);
 
@@ -1080,6 +1091,181 @@ int ZoneHeapThreadSafe::checkTag(void *ptr, const std::source_location loc)
     return ZoneHeapBase::checkTag(ptr, loc);
 }
 
+//=============================================================================
+//
+// ZoneSlab class methods
+//
+
+ZoneSlab *ZoneSlab::slabs;
+
+//
+// Size of the chunks carved into slots of the given size; always room for a
+// decent number of slots even in the largest classes.
+//
+static size_t Z_slabChunkSize(size_t slotsize)
+{
+    return emax(ZoneSlab::CHUNKSIZE / slotsize, size_t(16)) * slotsize;
+}
+
+//
+// ZoneSlab Constructor
+//
+// Slabs are meant to be static objects; each one is remembered so that its
+// chunks can be forgotten when their tag is freed.
+//
+ZoneSlab::ZoneSlab(const char *name, int tag) : name(name), tag(tag), classes(), oversized(0)
+{
+    nextslab = slabs;
+    slabs    = this;
+}
+
+//
+// ZoneSlab::alloc
+//
+// Returns a zeroed slot of at least size bytes, taking it from the free list
+// when one is available so that it is still warm in the cache.
+//
+void *ZoneSlab::alloc(size_t size)
+{
+    if(!Fits(size))
+    {
+        ++oversized;
+        return Z_Calloc(1, size, tag, nullptr);
+    }
+
+    const size_t slotsize = (size + GRANULARITY - 1) & ~(GRANULARITY - 1);
+    sizeclass_t &sc       = classes[slotsize / GRANULARITY - 1];
+    void        *ret;
+
+    if(sc.freelist)
+    {
+        ret         = sc.freelist;
+        sc.freelist = sc.freelist->next;
+        ++sc.reuses;
+    }
+    else
+    {
+        if(sc.chunkpos == sc.chunkend)
+        {
+            const size_t chunksize = Z_slabChunkSize(slotsize);
+
+            sc.chunkpos = static_cast<byte *>(Z_Malloc(chunksize, tag, nullptr));
+            sc.chunkend = sc.chunkpos + chunksize;
+            ++sc.chunks;
+        }
+        ret          = sc.chunkpos;
+        sc.chunkpos += slotsize;
+    }
+
+    if(++sc.live > sc.peak)
+        sc.peak = sc.live;
+    ++sc.allocs;
+
+    return memset(ret, 0, slotsize);
+}
+
+//
+// ZoneSlab::free
+//
+// Puts a slot back on the free list of its size class. size must be the size
+// that was passed to alloc.
+//
+void ZoneSlab::free(void *ptr, size_t size)
+{
+    if(!ptr)
+        return;
+
+    if(!Fits(size))
+    {
+        Z_Free(ptr);
+        return;
+    }
+
+    const size_t slotsize = (size + GRANULARITY - 1) & ~(GRANULARITY - 1);
+    sizeclass_t &sc       = classes[slotsize / GRANULARITY - 1];
+    freeslot_t  *slot     = static_cast<freeslot_t *>(ptr);
+
+    SCRAMBLER(ptr, slotsize);
+
+    slot->next  = sc.freelist;
+    sc.freelist = slot;
+    --sc.live;
+}
+
+//
+// ZoneSlab::FreeTags
+//
+// Called from Z_FreeTags after the objects of those tags have been deleted
+// and before their blocks are freed. The chunks are about to go away with
+// the rest of the tag, so every slab using it starts over empty.
+//
+void ZoneSlab::FreeTags(int lowtag, int hightag)
+{
+    for(ZoneSlab *slab = slabs; slab; slab = slab->nextslab)
+    {
+        if(slab->tag < lowtag || slab->tag > hightag)
+            continue;
+
+        for(sizeclass_t &sc : slab->classes)
+        {
+            sc.freelist = nullptr;
+            sc.chunkpos = sc.chunkend = nullptr;
+            sc.chunks = sc.live = 0;
+        }
+    }
+}
+
+//
+// ZoneSlab::PrintStats
+//
+// Lists every size class that has been used since the last reset.
+//
+void ZoneSlab::PrintStats()
+{
+    for(const ZoneSlab *slab = slabs; slab; slab = slab->nextslab)
+    {
+        size_t totalchunks = 0, totallive = 0;
+
+        C_Printf(FC_HI "%s" FC_NORMAL "\n  size   live   peak     allocs     reused  chunk KB\n", slab->name);
+
+        for(int i = 0; i < NUMCLASSES; i++)
+        {
+            const sizeclass_t &sc       = slab->classes[i];
+            const size_t       slotsize = (i + 1) * GRANULARITY;
+
+            if(!sc.allocs && !sc.chunks)
+                continue;
+
+            C_Printf("%6zu %6zu %6zu %10zu %10zu %9zu\n", slotsize, sc.live, sc.peak, sc.allocs, sc.reuses,
+                     sc.chunks * Z_slabChunkSize(slotsize) / 1024);
+
+            totalchunks += sc.chunks;
+            totallive   += sc.live * slotsize;
+        }
+
+        C_Printf("%zu chunks, %zu KB in use, %zu oversized allocations\n", totalchunks, totallive / 1024,
+                 slab->oversized);
+    }
+}
+
+//
+// ZoneSlab::ResetStats
+//
+// Clears the counters without touching any live slots.
+//
+void ZoneSlab::ResetStats()
+{
+    for(ZoneSlab *slab = slabs; slab; slab = slab->nextslab)
+    {
+        for(sizeclass_t &sc : slab->classes)
+        {
+            sc.peak   = sc.live;
+            sc.allocs = sc.reuses = 0;
+        }
+        slab->oversized = 0;
+    }
+}
+
 //=============================================================================
 //
 // ZoneObject class methods
@@ -1105,18 +1291,34 @@ void *ZoneObject::operator new(size_t size, int tag, void **user)
     return (newalloc = Z_Calloc(1, size, tag, user));
 }
 
+//
+// ZoneObject::operator new
+//
+// Overload allocating the object from a slab. Such objects take the slab's
+// tag and are deleted along with the rest of it. Objects too large for a slot
+// get an ordinary zone block, and are treated as such.
+//
+void *ZoneObject::operator new(size_t size, ZoneSlab &slab)
+{
+    if(ZoneSlab::Fits(size))
+        newslab = &slab;
+    return (newalloc = slab.alloc(size));
+}
+
 //
 // ZoneObject Constructor
 //
 // If the ZoneObject::newalloc static is set, it will be picked up by the
 // subsequent constructor call and stored in the object that was allocated.
 //
-ZoneObject::ZoneObject() : zonealloc(nullptr), zonenext(nullptr), zoneprev(nullptr)
+ZoneObject::ZoneObject() : zonealloc(nullptr), zoneslab(nullptr), zonenext(nullptr), zoneprev(nullptr)
 {
     if(newalloc)
     {
         zonealloc = newalloc;
+        zoneslab  = newslab;
         newalloc  = nullptr;
+        newslab   = nullptr;
         addToTagList(getZoneTag());
     }
 }
@@ -1164,6 +1366,10 @@ void ZoneObject::changeTag(int tag)
         if(tag == curtag)
             return;
 
+        // a slot can't leave the chunk it was carved from
+        if(zoneslab)
+            I_Error("ZoneObject::changeTag: can't change the tag of a slab object\n");
+
         // remove from current tag list, if in one
         removeFromTagList();
 
@@ -1211,6 +1417,16 @@ void ZoneObject::operator delete(void *p, int, void **)
     Z_Free(p);
 }
 
+//
+// ZoneObject::operator delete
+//
+// Matches the slab operator new for when a constructor throws. The size isn't
+// known here, so the slot is simply left until the slab's tag is freed.
+//
+void ZoneObject::operator delete(void *, ZoneSlab &)
+{
+}
+
 //
 // ZoneObject::FreeTags
 //
@@ -1256,7 +1472,9 @@ int ZoneObject::getZoneTag() const
 {
     int tag = PU_FREE;
 
-    if(zonealloc)
+    if(zoneslab)
+        tag = zoneslab->getTag();
+    else if(zonealloc)
     {
         memblock_t *block = (memblock_t *)((byte *)zonealloc - header_size);
         tag               = block->tag;
@@ -1276,14 +1494,14 @@ int ZoneObject::getZoneTag() const
 // but it's implemented through black magic inline-asm hackery in Delphi. I
 // think I've won that one easily as far as elegance goes :P
 //
-// Returns 0 if the object is not a zone allocation. You'll need to use some
-// other method of getting an object's size in that case.
+// Returns 0 if the object is not a zone allocation, or lives in a slab. You'll
+// need to use some other method of getting an object's size in that case.
 //
 size_t ZoneObject::getZoneSize() const
 {
     size_t retsize = 0;
 
-    if(zonealloc)
+    if(zonealloc && !zoneslab)
     {
         memblock_t *block = (memblock_t *)((byte *)zonealloc - header_size);
         retsize           = block->size;
@@ -56,6 +56,7 @@
 #include <time.h>
 
 // haleyjd: C++ headers
+#include <atomic>
 #include <new>
 #include <type_traits>
 #include <source_location>
@@ -176,6 +177,9 @@ class ZoneHeapBase
 protected:
     struct memblock_t *m_blockbytag[PU_MAX]; // used for tracking all zone blocks
 
+    // bumped whenever a block with an owner is freed or moved
+    std::atomic<unsigned int> m_ownergeneration = 0;
+
 #ifdef INSTRUMENTED
     size_t m_memorybytag[PU_MAX];
 #endif
@@ -198,6 +202,12 @@ public:
     void print(const char *filename);
     void dumpCore(const char *filename);
 
+    //
+    // Changes whenever a block with an owner (such as a cached lump) is freed
+    // or moved, so anything keyed on such blocks' addresses knows to drop it.
+    //
+    unsigned int ownerGeneration() const { return m_ownergeneration.load(std::memory_order_relaxed); }
+
 #ifdef INSTRUMENTED
     inline size_t memoryForTag(const int tag) { return m_memorybytag[tag]; }
 #endif
@@ -275,6 +285,59 @@ public:
     virtual int   checkTag(void *, const std::source_location loc = std::source_location::current()) override;
 };
 
+//
+// Pool of fixed-size slots for objects that are created and destroyed in
+// great numbers. Slots are carved out of large zone blocks allocated with the
+// pool's tag, recycled through a free list per size class, and all released
+// together when that tag is freed. Only the main thread may use a slab.
+//
+class ZoneSlab
+{
+public:
+    static constexpr size_t GRANULARITY = 16;   // slot sizes are multiples of this
+    static constexpr size_t MAXSLOTSIZE = 2048; // larger objects go to the zone heap
+    static constexpr size_t CHUNKSIZE   = 65536;
+    static constexpr int    NUMCLASSES  = MAXSLOTSIZE / GRANULARITY;
+
+    ZoneSlab(const char *name, int tag);
+
+    void *alloc(size_t size);
+    void  free(void *ptr, size_t size);
+
+    int getTag() const { return tag; }
+
+    // Whether an object of this size gets a slot, rather than a zone block
+    static bool Fits(size_t size) { return size && size <= MAXSLOTSIZE; }
+
+    static void FreeTags(int lowtag, int hightag);
+    static void PrintStats();
+    static void ResetStats();
+
+private:
+    struct freeslot_t
+    {
+        freeslot_t *next;
+    };
+
+    struct sizeclass_t
+    {
+        freeslot_t    *freelist;           // slots given back by free
+        unsigned char *chunkpos, *chunkend; // unused tail of the newest chunk
+        size_t         chunks;             // chunks allocated under the current tag
+        size_t         live, peak;         // slots in use
+        size_t         allocs, reuses;     // allocations, and how many came off the free list
+    };
+
+    const char *name;
+    int         tag;
+    ZoneSlab   *nextslab; // all slabs, for FreeTags and stats
+
+    sizeclass_t classes[NUMCLASSES];
+    size_t      oversized; // allocations too large for any class
+
+    static ZoneSlab *slabs;
+};
+
 //
 // This class serves as a base class for C++ objects that want to support
 // allocation on the zone heap.
@@ -285,9 +348,11 @@ private:
     // static data
     static ZoneObject *objectbytag[PU_MAX];
     static void       *newalloc;
+    static ZoneSlab   *newslab;
 
     // instance data
     void        *zonealloc; // If non-null, the object is living on the zone heap
+    ZoneSlab    *zoneslab;  // If non-null, zonealloc is a slot in this slab
     ZoneObject  *zonenext;  // Next object on tag chain
     ZoneObject **zoneprev;  // Previous object on tag chain's next pointer
 
@@ -299,8 +364,10 @@ public:
     virtual ~ZoneObject();
     void *operator new(size_t size);
     void *operator new(size_t size, int tag, void **user = nullptr);
+    void *operator new(size_t size, ZoneSlab &slab);
     void  operator delete(void *p);
     void  operator delete(void *p, int, void **);
+    void  operator delete(void *p, ZoneSlab &slab);
     void  changeTag(int tag);
 
     // zone memblock reflection